@@ -20,6 +20,8 @@
  *
  * Key features
  * - One-shot timers that automatically deactivate after expiration
+ * - Multi-shot timers that fire a fixed number of times without drift
+ * - Suspend/resume of timer sets across low-power modes that stop the clock
  * - External clock source abstraction via callback
  * - Overflow-safe arithmetic using unsigned integer operations
  * - Lightweight implementation suitable for resource-constrained systems
@@ -142,6 +144,21 @@ typedef uint32_t (*SoftwareTimer_ClockTime)(void);
  */
 void SoftwareTimer_Init(SoftwareTimer_ClockTime clock);
 
+/**
+ * @brief Returns current time of the clock source
+ *
+ * Reads the clock source registered with @ref SoftwareTimer_Init. Library
+ * modules built on top of the core timer use this function so that they share
+ * a single time base with all @ref SoftwareTimer instances.
+ *
+ * @return Current time value in ticks
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @see SoftwareTimer_Init
+ */
+uint32_t SoftwareTimer_Now(void);
+
 /**
  * @brief Sets and starts a software timer with specified interval
  *
@@ -286,6 +303,167 @@ uint32_t SoftwareTimer_Remaining(const SoftwareTimer * timer);
  */
 bool SoftwareTimer_IsExpiredEvaluatedOnce(SoftwareTimer * timer);
 
+/**
+ * @struct SoftwareTimer_Repeating
+ * @brief Multi-shot timer state structure
+ *
+ * Wraps a @ref SoftwareTimer with a repeat counter. The timer reports
+ * expiration once per interval until the counter is exhausted and then
+ * deactivates itself. Typical use is protocol retransmission that fires
+ * exactly N times and then gives up.
+ */
+typedef struct {
+    SoftwareTimer timer; /**< Underlying timer. timer.start is advanced by one interval on every reported expiration */
+    uint32_t count; /**< Number of expirations still to be reported. 0 means the timer is exhausted */
+} SoftwareTimer_Repeating;
+
+/**
+ * @brief Sets and starts a multi-shot timer
+ *
+ * Captures the current time from the clock source and configures the timer
+ * to expire @p count times, every @p interval ticks. Any previous timer state
+ * is overwritten.
+ *
+ * @param[in,out] timer Pointer to multi-shot timer structure. Must not be NULL.
+ * @param[in] interval Period between expirations in clock ticks.
+ * @param[in] count Number of expirations to report. Value 0 creates an
+ *                  already exhausted timer.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ * @post timer->count is set to @p count
+ *
+ * @see SoftwareTimer_IsExpiredRepeating
+ *
+ * Example:
+ * @code
+ * SoftwareTimer_Repeating retransmit;
+ * SoftwareTimer_SetRepeating(&retransmit, 200, 3); // 3 retries, 200 ticks apart
+ * @endcode
+ */
+void SoftwareTimer_SetRepeating(SoftwareTimer_Repeating * timer, uint32_t interval, uint32_t count);
+
+/**
+ * @brief Checks if multi-shot timer has expired (once per period)
+ *
+ * Returns true once for every elapsed interval until the repeat counter is
+ * exhausted. On every reported expiration the start timestamp is advanced by
+ * exactly one interval instead of being re-read from the clock, so the period
+ * does not drift with polling latency. When the last expiration is reported
+ * the timer deactivates itself and all further calls return false.
+ *
+ * @param[in,out] timer Pointer to multi-shot timer structure. Must not be NULL.
+ *
+ * @return true if an interval elapsed and repeats were left
+ * @return false if the timer is still running or is exhausted
+ *
+ * @pre @ref SoftwareTimer_SetRepeating must have been called
+ *
+ * @note Reads the clock at most once per call and not at all once exhausted.
+ * @note If several intervals elapsed between two calls, each call reports one
+ *       of them, so the timer still fires exactly @p count times.
+ *
+ * Example:
+ * @code
+ * if (SoftwareTimer_IsExpiredRepeating(&retransmit)) {
+ *     send_frame();
+ * } else if (SoftwareTimer_RepeatsLeft(&retransmit) == 0) {
+ *     give_up();
+ * }
+ * @endcode
+ */
+bool SoftwareTimer_IsExpiredRepeating(SoftwareTimer_Repeating * timer);
+
+/**
+ * @brief Returns number of expirations still to be reported
+ *
+ * @param[in] timer Pointer to multi-shot timer structure. Must not be NULL.
+ *
+ * @return Remaining repeat count
+ * @retval 0 if the timer is exhausted
+ *
+ * @note Does not read the clock.
+ */
+uint32_t SoftwareTimer_RepeatsLeft(const SoftwareTimer_Repeating * timer);
+
+/**
+ * @struct SoftwareTimer_Retained
+ * @brief Clock-independent snapshot of one timer
+ *
+ * Produced by @ref SoftwareTimer_Suspend. Place the snapshot array in memory
+ * that is retained during deep sleep.
+ */
+typedef struct {
+    uint32_t remaining; /**< Ticks remaining until expiration when the snapshot was taken */
+    bool evaluated; /**< Copy of the one-shot evaluation flag */
+} SoftwareTimer_Retained;
+
+/**
+ * @brief Snapshots remaining times of a timer set before deep sleep
+ *
+ * When the clock source stops or restarts during a low-power mode, the
+ * start timestamps of all timers become meaningless. This function stores
+ * the remaining time of each timer, which does not depend on the clock value.
+ *
+ * @param[in] timers Array of @p count timers. Must not be NULL.
+ * @param[out] retained Array of @p count snapshots. Must not be NULL.
+ * @param[in] count Number of timers.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @note Reads the clock once for the whole set, one pass over the arrays.
+ *
+ * @see SoftwareTimer_Resume
+ */
+void SoftwareTimer_Suspend(const SoftwareTimer * timers, SoftwareTimer_Retained * retained, uint32_t count);
+
+/**
+ * @brief Re-bases a timer set after deep sleep
+ *
+ * Restarts every timer at the current clock time with its remaining time
+ * reduced by @p slept, the sleep duration measured by an always-on clock such
+ * as the RTC (converted to clock ticks). Timers that would have expired
+ * during sleep are expired after resume. The evaluated flags are restored, so
+ * @ref SoftwareTimer_IsExpiredEvaluatedOnce reports each expiration once.
+ *
+ * @param[out] timers Array of @p count timers. Must not be NULL.
+ * @param[in] retained Array of @p count snapshots from @ref SoftwareTimer_Suspend. Must not be NULL.
+ * @param[in] count Number of timers.
+ * @param[in] slept Time spent in the low-power mode, in clock ticks.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called (again, if the clock
+ *      source was re-initialized on wake)
+ *
+ * @note Reads the clock once for the whole set, one pass over the arrays.
+ *
+ * Example:
+ * @code
+ * static SoftwareTimer timers[8];
+ * static SoftwareTimer_Retained retained[8] __attribute__((section(".retention")));
+ *
+ * SoftwareTimer_Suspend(timers, retained, 8);
+ * uint32_t before = Rtc_Millis();
+ * Enter_DeepSleep();
+ * SoftwareTimer_Resume(timers, retained, 8, Rtc_Millis() - before);
+ * @endcode
+ */
+void SoftwareTimer_Resume(SoftwareTimer * timers, const SoftwareTimer_Retained * retained, uint32_t count, uint32_t slept);
+
+#ifdef SOFTWARETIMER_STATS
+/**
+ * @brief Returns the number of clock source reads
+ *
+ * Counts every read made by the library, including reads by the optional
+ * modules through @ref SoftwareTimer_Now. The counter wraps at UINT32_MAX.
+ * It is updated with relaxed atomics (C11 or GCC builtins), so it can be
+ * read from any thread.
+ *
+ * @return Clock reads since start-up
+ *
+ * @note Available only when @c SOFTWARETIMER_STATS is defined.
+ */
+uint32_t SoftwareTimer_ClockReads(void);
+#endif
+
 /** @} */ // end of software_timer_core group
 
 #ifdef __cplusplus
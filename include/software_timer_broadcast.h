@@ -0,0 +1,138 @@
+/**
+ * @file software_timer_broadcast.h
+ * @brief Fan-out timers: one periodic manager entry notifying many subscribers
+ * @author Richard Kubíček
+ *
+ * Many modules need the same heartbeat ("every 100 ms"). Arming one periodic
+ * entry per module makes the manager list, its insertion cost and the work
+ * per expiration grow with the number of modules. A broadcast timer is a
+ * single periodic @ref SoftwareTimer_Entry with a list of subscribers behind
+ * it: the manager holds one entry per distinct period, and one expiration
+ * notifies every subscriber.
+ *
+ * Design highlights
+ * - Subscribers are intrusive and provided by the caller, no dynamic
+ *   allocation. Subscribing and unsubscribing are O(1).
+ * - The manager entry is armed when the first subscriber joins and stopped
+ *   when the last one leaves, so an idle broadcast costs nothing per tick.
+ * - Subscribers share the phase of the broadcast: a subscriber that joins
+ *   late is notified on the next common expiration, not one full period
+ *   after joining.
+ * - A subscriber callback may unsubscribe itself or any other subscriber
+ *   and may subscribe new ones; subscribers added during a notification
+ *   are first notified on the next expiration.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Broadcast tick100ms;
+ * static SoftwareTimer_Subscriber ledTick, logTick;
+ *
+ * SoftwareTimer_BroadcastInit(&tick100ms, &manager, SOFTWARETIMER_MS(100));
+ * SoftwareTimer_SubscriberInit(&ledTick, Led_Update, NULL);
+ * SoftwareTimer_SubscriberInit(&logTick, Log_Flush, NULL);
+ * SoftwareTimer_BroadcastSubscribe(&tick100ms, &ledTick);
+ * SoftwareTimer_BroadcastSubscribe(&tick100ms, &logTick);
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_BROADCAST_H
+#define SOFTWARE_TIMER_BROADCAST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include "software_timer_manager.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_broadcast Broadcast timers
+ * @brief One periodic entry fanning out to many subscribers
+ * @{
+ */
+
+typedef struct SoftwareTimer_Subscriber SoftwareTimer_Subscriber;
+typedef struct SoftwareTimer_Broadcast SoftwareTimer_Broadcast;
+
+/**
+ * @typedef SoftwareTimer_SubscriberCallback
+ * @brief Function called for a subscriber on every expiration of its broadcast
+ *
+ * @param[in,out] subscriber Notified subscriber; user data is available as
+ *                           subscriber->context
+ */
+typedef void (*SoftwareTimer_SubscriberCallback)(SoftwareTimer_Subscriber * subscriber);
+
+/**
+ * @struct SoftwareTimer_Subscriber
+ * @brief Subscription to a @ref SoftwareTimer_Broadcast
+ */
+struct SoftwareTimer_Subscriber {
+    SoftwareTimer_SubscriberCallback callback; /**< Function called on every expiration */
+    void * context; /**< User data for the callback */
+    SoftwareTimer_Broadcast * broadcast; /**< Broadcast subscribed to, NULL if not subscribed */
+    SoftwareTimer_Subscriber * next; /**< Next subscriber of the broadcast */
+    SoftwareTimer_Subscriber * prev; /**< Previous subscriber of the broadcast */
+};
+
+/**
+ * @struct SoftwareTimer_Broadcast
+ * @brief Broadcast timer state structure
+ */
+struct SoftwareTimer_Broadcast {
+    SoftwareTimer_Entry entry; /**< Periodic entry armed in the manager. entry.missed is valid during notification */
+    SoftwareTimer_Manager * manager; /**< Manager the entry is armed in */
+    uint32_t period; /**< Period in clock ticks */
+    SoftwareTimer_Subscriber * head; /**< Most recently added subscriber */
+    SoftwareTimer_Subscriber * cursor; /**< Next subscriber to notify while an expiration is dispatched */
+};
+
+/**
+ * @brief Initializes a broadcast without subscribers
+ *
+ * @param[out] broadcast Pointer to broadcast structure. Must not be NULL.
+ * @param[in,out] manager Manager that dispatches the broadcast. Must not be NULL.
+ * @param[in] period Period in clock ticks, greater than 0 and at most INT32_MAX.
+ */
+void SoftwareTimer_BroadcastInit(SoftwareTimer_Broadcast * broadcast, SoftwareTimer_Manager * manager, uint32_t period);
+
+/**
+ * @brief Initializes a subscriber that is not subscribed
+ *
+ * @param[out] subscriber Pointer to subscriber structure. Must not be NULL.
+ * @param[in] callback Function called on every expiration. Must not be NULL.
+ * @param[in] context User data available to the callback as subscriber->context.
+ */
+void SoftwareTimer_SubscriberInit(SoftwareTimer_Subscriber * subscriber, SoftwareTimer_SubscriberCallback callback, void * context);
+
+/**
+ * @brief Adds a subscriber to a broadcast
+ *
+ * The first subscriber arms the broadcast one period from now.
+ *
+ * @param[in,out] broadcast Pointer to broadcast. Must not be NULL.
+ * @param[in,out] subscriber Pointer to subscriber that is not subscribed. Must not be NULL.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_BroadcastSubscribe(SoftwareTimer_Broadcast * broadcast, SoftwareTimer_Subscriber * subscriber);
+
+/**
+ * @brief Removes a subscriber from its broadcast
+ *
+ * Unsubscribing a subscriber that is not subscribed has no effect. The
+ * last subscriber stops the broadcast.
+ *
+ * @param[in,out] subscriber Pointer to subscriber. Must not be NULL.
+ */
+void SoftwareTimer_BroadcastUnsubscribe(SoftwareTimer_Subscriber * subscriber);
+
+/** @} */ // end of software_timer_broadcast group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_BROADCAST_H
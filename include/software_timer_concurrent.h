@@ -0,0 +1,227 @@
+/**
+ * @file software_timer_concurrent.h
+ * @brief Timer manager with arming from any thread
+ * @author Richard Kubíček
+ *
+ * A @ref SoftwareTimer_Manager must only be touched by one thread. Routing
+ * every arm through that thread (or a mutex) becomes the bottleneck when
+ * many threads arm timers at a high rate. This module lets any thread arm
+ * and cancel entries directly; the thread that processes the manager applies
+ * the requests.
+ *
+ * Design highlights
+ * - Arm and cancel requests are pushed onto an intrusive stack. Nothing is
+ *   allocated.
+ * - The processing thread detaches the whole stack with one atomic exchange
+ *   and links the entries into its private deadline-sorted manager.
+ * - Every entry carries a state word. Cancel only changes that word; the
+ *   processing thread never has to unlink anything from a shared list, and
+ *   an entry whose state is no longer "armed" is dropped instead of fired.
+ * - The start time is captured by the arming thread, so the time a request
+ *   waits on the stack does not delay its deadline.
+ * - An arm costs three atomic read-modify-write operations: a
+ *   compare-and-swap that claims the entry's request fields, one that
+ *   publishes the request and one that pushes the entry onto the stack. The
+ *   push is skipped while the entry still is on the stack. Cancel costs the
+ *   same.
+ * - The claim spins while another thread writes a request for the same
+ *   entry, so arming one entry from several threads is not lock-free: a
+ *   writer preempted in the middle of its request stalls the others. Write
+ *   requests for a given entry from one thread where that matters.
+ * - All threads push onto the same stack head, so its cache line is
+ *   contended when many threads arm at a high rate. The push is lock-free
+ *   but retries its compare-and-swap under contention.
+ * - @ref SoftwareTimer_ConcurrentCancelSync waits until the processing thread
+ *   no longer references the entry, so its memory can be freed right after.
+ *   Only the cancelling thread waits; firing never blocks.
+ *
+ * Requires C11 atomics (@c stdatomic.h); the implementation is not compiled
+ * by C99 compilers or where @c __STDC_NO_ATOMICS__ is defined. The header is
+ * C only, since its structures embed @c _Atomic members: C++ code calls the
+ * module through functions of its own C translation unit.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Concurrent timers;
+ *
+ * // Processing thread
+ * SoftwareTimer_ConcurrentInit(&timers);
+ * while (running) {
+ *     uint32_t idle = SoftwareTimer_ConcurrentProcess(&timers);
+ *     Event_WaitFor(idle); // woken when an arm returns true
+ * }
+ *
+ * // Any thread
+ * SoftwareTimer_ConcurrentEntryInit(&request->timeout, on_timeout, request);
+ * if (SoftwareTimer_ConcurrentArm(&timers, &request->timeout, 500)) {
+ *     Event_Signal();
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_CONCURRENT_H
+#define SOFTWARE_TIMER_CONCURRENT_H
+
+#ifdef __cplusplus
+    #error "software_timer_concurrent.h is C only: C++ has no _Atomic; wrap the API in a C translation unit"
+#elif !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+    #error "software_timer_concurrent.h requires C11 atomics"
+#endif
+
+#include "software_timer.h"
+#include "software_timer_manager.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_concurrent Concurrent arming
+ * @brief Arm and cancel from any thread
+ * @{
+ */
+
+typedef struct SoftwareTimer_ConcurrentEntry SoftwareTimer_ConcurrentEntry;
+
+/**
+ * @struct SoftwareTimer_ConcurrentEntry
+ * @brief Entry that can be armed and cancelled from any thread
+ *
+ * The callback receives a pointer to the embedded entry, which is the first
+ * member: cast it to @ref SoftwareTimer_ConcurrentEntry if needed. User data
+ * is available as entry->context.
+ */
+struct SoftwareTimer_ConcurrentEntry {
+    SoftwareTimer_Entry entry; /**< Entry linked by the processing thread. Must stay the first member */
+    _Atomic uint32_t state; /**< Request state word, see software_timer_concurrent.c */
+    _Atomic uint32_t requestStart; /**< Start time of the latest arm request */
+    _Atomic uint32_t requestInterval; /**< First interval of the latest arm request */
+    _Atomic uint32_t requestPeriod; /**< Period of the latest arm request, 0 for one-shot */
+    SoftwareTimer_ConcurrentEntry * pendingNext; /**< Next entry on the request stack */
+};
+
+/**
+ * @struct SoftwareTimer_Concurrent
+ * @brief Concurrent manager state structure
+ */
+typedef struct {
+    SoftwareTimer_Manager manager; /**< Armed entries, private to the processing thread */
+    _Atomic(SoftwareTimer_ConcurrentEntry *) pending; /**< Stack of entries with unapplied requests */
+    void (*wake)(void * context); /**< Wakes the processing thread, NULL if it polls */
+    void * wakeContext; /**< Argument of wake */
+} SoftwareTimer_Concurrent;
+
+/**
+ * @enum SoftwareTimer_CancelResult
+ * @brief Outcome of @ref SoftwareTimer_ConcurrentCancelSync
+ */
+typedef enum {
+    SOFTWARETIMER_CANCEL_INACTIVE, /**< Nothing was pending: the callback already ran or the entry was never armed */
+    SOFTWARETIMER_CANCEL_PREVENTED, /**< A pending expiration was cancelled before its callback started */
+    SOFTWARETIMER_CANCEL_WAITED /**< The callback was running; the call returned after it finished */
+} SoftwareTimer_CancelResult;
+
+/**
+ * @brief Initializes an empty concurrent manager
+ *
+ * @param[out] concurrent Pointer to manager structure. Must not be NULL.
+ */
+void SoftwareTimer_ConcurrentInit(SoftwareTimer_Concurrent * concurrent);
+
+/**
+ * @brief Sets the function that wakes a sleeping processing thread
+ *
+ * Called by @ref SoftwareTimer_ConcurrentCancelSync after publishing its
+ * request, since the cancelling thread cannot signal while it waits. Without it the processing thread must call
+ * @ref SoftwareTimer_ConcurrentProcess periodically.
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ * @param[in] wake Function callable from any thread, or NULL.
+ * @param[in] context Argument passed to @p wake.
+ */
+void SoftwareTimer_ConcurrentSetWake(SoftwareTimer_Concurrent * concurrent, void (*wake)(void * context), void * context);
+
+/**
+ * @brief Initializes an entry in the stopped state
+ *
+ * @param[out] entry Pointer to entry structure. Must not be NULL.
+ * @param[in] callback Function called by the processing thread on expiration. Must not be NULL.
+ * @param[in] context User data available to the callback as entry->context.
+ */
+void SoftwareTimer_ConcurrentEntryInit(SoftwareTimer_ConcurrentEntry * entry, SoftwareTimer_Callback callback, void * context);
+
+/**
+ * @brief Arms a one-shot entry from any thread
+ *
+ * Captures the current time; the entry expires @p interval ticks later. A
+ * request replaces any earlier request for the same entry.
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] interval Interval in clock ticks, at most INT32_MAX.
+ *
+ * @return true if the request stack was empty: wake the processing thread
+ *         if it may be sleeping past the new deadline
+ */
+bool SoftwareTimer_ConcurrentArm(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t interval);
+
+/**
+ * @brief Arms a periodic entry from any thread
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] period Period in clock ticks, greater than 0 and at most INT32_MAX.
+ *
+ * @return Same as @ref SoftwareTimer_ConcurrentArm
+ */
+bool SoftwareTimer_ConcurrentArmPeriodic(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t period);
+
+/**
+ * @brief Cancels an entry from any thread
+ *
+ * After the call the processing thread will not start the callback for any
+ * earlier request. A callback that the processing thread already started
+ * may still be running.
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ */
+void SoftwareTimer_ConcurrentCancel(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry);
+
+/**
+ * @brief Cancels an entry and waits until the processing thread releases it
+ *
+ * Like @ref SoftwareTimer_ConcurrentCancel, then spins until a running
+ * callback of the entry has returned and the processing thread has applied
+ * the cancel. Afterwards the processing thread holds no reference to the
+ * entry: it and its context may be freed.
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ *
+ * @return Whether the callback was prevented, had to be waited for or had
+ *         nothing pending
+ *
+ * @warning Never call it from the processing thread, including the entry's
+ *          own callback: it would wait for itself. No other thread may arm
+ *          the entry during the call, and a callback that re-arms its own
+ *          entry must stop doing so first, as with Linux @c del_timer_sync.
+ */
+SoftwareTimer_CancelResult SoftwareTimer_ConcurrentCancelSync(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry);
+
+/**
+ * @brief Applies pending requests and fires expired entries
+ *
+ * Processing thread only.
+ *
+ * @param[in,out] concurrent Pointer to manager. Must not be NULL.
+ *
+ * @return Number of ticks until the next deadline
+ * @retval 0 if a deadline is due or a request was being written while the
+ *         stack was drained; call again without sleeping
+ * @retval SOFTWARETIMER_NO_DEADLINE if no entry is armed
+ */
+uint32_t SoftwareTimer_ConcurrentProcess(SoftwareTimer_Concurrent * concurrent);
+
+/** @} */ // end of software_timer_concurrent group
+
+#endif // SOFTWARE_TIMER_CONCURRENT_H
@@ -73,4 +73,106 @@
     } while(0)
 */
 
+/* ============================================================================
+ * Critical-Section Strategy
+ * ============================================================================
+ * Selects how the timer manager protects its entry list when it is used
+ * from more than one execution context. The choice is made at compile time
+ * for the whole build and expands to the selected primitive directly,
+ * without run-time dispatch. Protected are arming, stopping, popping
+ * expired entries, the next-deadline queries, the wakeup grid, the walk of
+ * SoftwareTimer_ManagerVisit() and the manager statistics updates;
+ * SoftwareTimer_MetricsSnapshot() reads the statistics with relaxed atomic
+ * loads and never takes the lock. Callbacks and the visitor of
+ * SoftwareTimer_ManagerVisit() always run outside of the critical section;
+ * the walk holds it for at most SOFTWARETIMER_VISIT_BATCH entries at a
+ * time.
+ *
+ * - SOFTWARETIMER_CRITICAL_NONE (0, default): no protection. The manager is
+ *   used from a single thread or main loop only.
+ * - SOFTWARETIMER_CRITICAL_IRQ (1): interrupts are disabled and restored,
+ *   for single-core MCUs where ISRs arm or stop entries. Built in for
+ *   Cortex-M with GCC/Clang (PRIMASK); elsewhere define
+ *   SOFTWARETIMER_IRQ_DISABLE() returning the previous state and
+ *   SOFTWARETIMER_IRQ_RESTORE(state).
+ * - SOFTWARETIMER_CRITICAL_SPINLOCK (2): spinlock for multi-core MCUs. The
+ *   default lock uses GCC atomic builtins and does not mask interrupts;
+ *   define SOFTWARETIMER_SPIN_LOCK() and SOFTWARETIMER_SPIN_UNLOCK(state) to
+ *   use a hardware spinlock that also masks interrupts, which is required
+ *   when ISRs use the manager and on cores without atomic instructions
+ *   (Cortex-M0+, RP2040).
+ * - SOFTWARETIMER_CRITICAL_PTHREAD (3): one pthread mutex, for hosted
+ *   multi-threaded builds.
+ */
+/*
+#define SOFTWARETIMER_CRITICAL 1
+*/
+
+/*
+ * RP2040 (Pico SDK) example: hardware spinlock with interrupts masked
+ */
+/*
+#include "hardware/sync.h"
+#define SOFTWARETIMER_CRITICAL 2
+#define SOFTWARETIMER_SPIN_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1))
+#define SOFTWARETIMER_SPIN_UNLOCK(state) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), state)
+*/
+
+/* ============================================================================
+ * Tick Rate Configuration
+ * ============================================================================
+ * Number of clock ticks per second of the clock source passed to
+ * SoftwareTimer_Init(). Used by SOFTWARETIMER_MS() and the other conversions
+ * in software_timer_units.h and by the POSIX helpers to convert ticks to
+ * struct timespec. Defaults to 1000 (millisecond ticks); must not be 0.
+ */
+/*
+#define SOFTWARETIMER_TICK_HZ 1000000u
+*/
+
+/* ============================================================================
+ * Statistics
+ * ============================================================================
+ * Define to count clock reads and to maintain per-manager counters (armed
+ * entries, expirations, lateness histogram, dispatch budget overruns) read by
+ * software_timer_metrics.h, and to store owner tags of manager entries for
+ * introspection. Changes the layout of SoftwareTimer_Manager and
+ * SoftwareTimer_Entry, so define it for the whole build, not per file.
+ */
+/*
+#define SOFTWARETIMER_STATS
+*/
+
+/* ============================================================================
+ * Early-Wake Margin (POSIX)
+ * ============================================================================
+ * Upper bound in nanoseconds of the margin by which SoftwareTimer_SleepUntil()
+ * wakes before a deadline to absorb scheduler latency; the rest of the wait
+ * is spun. Defaults to 2000000 (2 ms).
+ */
+/*
+#define SOFTWARETIMER_SLEEP_MAX_MARGIN_NS 200000u
+*/
+
+/* ============================================================================
+ * FreeRTOS Integration
+ * ============================================================================
+ * Define to compile src/software_timer_freertos.c (tick hook and tickless
+ * idle integration). Requires FreeRTOS headers on the include path.
+ */
+/*
+#define SOFTWARETIMER_FREERTOS
+*/
+
+/* ============================================================================
+ * io_uring Backend (Linux)
+ * ============================================================================
+ * Define to compile src/software_timer_iouring.c, which keeps the manager's
+ * earliest deadline as an io_uring timeout and falls back to a timerfd when
+ * the ring cannot be created. Requires liburing.
+ */
+/*
+#define SOFTWARETIMER_IOURING
+*/
+
 #endif /* SOFTWARE_TIMER_CONFIG_H */
@@ -0,0 +1,134 @@
+/**
+ * @file software_timer_context.h
+ * @brief Deadline propagation contexts with cascading cancel
+ * @author Richard Kubíček
+ *
+ * Nested operations with timeouts (request, database call, retry) create one
+ * context per level. A child context never outlives its parent: its effective
+ * deadline is the earlier of its own timeout and the parent's deadline, and
+ * cancelling a parent makes every descendant report "done".
+ *
+ * Design highlights
+ * - Cancel is O(1): it bumps the context's generation counter. Children
+ *   remember the generation of their parent and see the mismatch; no list of
+ *   children is kept and no tree walk is needed.
+ * - The effective deadline is computed once when the child is created, so
+ *   expiry checks are a single @ref SoftwareTimer comparison.
+ * - @ref SoftwareTimer_ContextIsDone follows the parent pointers to check the
+ *   generations, O(depth) with typical depths of two or three.
+ * - Contexts are caller-provided; a parent must stay valid (not go out of
+ *   scope) while its children are in use.
+ *
+ * Usage example:
+ * @code
+ * // Zeroed once: ContextInit advances the generation the storage holds
+ * SoftwareTimer_Context request = {0}, query = {0};
+ *
+ * SoftwareTimer_ContextInit(&request, NULL, 2000);
+ * SoftwareTimer_ContextInit(&query, &request, 5000); // still ends with request
+ *
+ * while (!SoftwareTimer_ContextIsDone(&query)) {
+ *     if (Db_Poll()) {
+ *         break;
+ *     }
+ * }
+ *
+ * // Client went away: query and everything below it is done, too
+ * SoftwareTimer_ContextCancel(&request);
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_CONTEXT_H
+#define SOFTWARE_TIMER_CONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_context Deadline contexts
+ * @brief Nested deadlines with O(1) cascading cancel
+ * @{
+ */
+
+typedef struct SoftwareTimer_Context SoftwareTimer_Context;
+
+/**
+ * @struct SoftwareTimer_Context
+ * @brief Deadline context state structure
+ *
+ * Zero-initialize the storage of a context once before its first
+ * @ref SoftwareTimer_ContextInit (static storage already is). Re-initializing
+ * a context advances its generation, so children of the previous use are
+ * invalidated as well.
+ */
+struct SoftwareTimer_Context {
+    SoftwareTimer deadline; /**< Effective deadline: earlier of the own timeout and the parent deadline */
+    const SoftwareTimer_Context * parent; /**< Parent context, NULL for a root */
+    uint32_t parentGeneration; /**< Generation of the parent when this context was created */
+    uint32_t generation; /**< Incremented by cancel and re-initialization */
+    bool cancelled; /**< Set by @ref SoftwareTimer_ContextCancel */
+};
+
+/**
+ * @brief Creates a context
+ *
+ * @param[in,out] context Pointer to context structure. Must not be NULL.
+ * @param[in] parent Parent context or NULL for a root context.
+ * @param[in] timeout Own timeout in clock ticks. The effective deadline is
+ *                    shortened to the parent deadline if that is earlier.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @note Reads the clock once. A child of a parent that is already done is
+ *       done immediately.
+ */
+void SoftwareTimer_ContextInit(SoftwareTimer_Context * context, const SoftwareTimer_Context * parent, uint32_t timeout);
+
+/**
+ * @brief Cancels a context and all of its descendants
+ *
+ * @param[in,out] context Pointer to context. Must not be NULL.
+ *
+ * @note O(1), does not read the clock.
+ */
+void SoftwareTimer_ContextCancel(SoftwareTimer_Context * context);
+
+/**
+ * @brief Checks if work under a context should stop
+ *
+ * @param[in] context Pointer to context. Must not be NULL.
+ *
+ * @return true if the effective deadline passed or the context or any
+ *         ancestor was cancelled (or re-initialized)
+ * @return false otherwise
+ *
+ * @note Reads the clock once.
+ */
+bool SoftwareTimer_ContextIsDone(const SoftwareTimer_Context * context);
+
+/**
+ * @brief Returns time left under a context
+ *
+ * Use it as the timeout of blocking operations performed under the context.
+ *
+ * @param[in] context Pointer to context. Must not be NULL.
+ *
+ * @return Ticks until the effective deadline
+ * @retval 0 if the context is done
+ *
+ * @note Reads the clock once.
+ */
+uint32_t SoftwareTimer_ContextRemaining(const SoftwareTimer_Context * context);
+
+/** @} */ // end of software_timer_context group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_CONTEXT_H
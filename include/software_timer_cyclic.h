@@ -0,0 +1,163 @@
+/**
+ * @file software_timer_cyclic.h
+ * @brief Time-triggered cyclic executive driven by a static frame table
+ * @author Richard Kubíček
+ *
+ * Safety-critical control loops are often scheduled as a cyclic executive:
+ * time is divided into minor frames of fixed length, every task runs in
+ * fixed frames given by its period and offset, and the pattern repeats
+ * every major frame. The schedule is decided once, not at run time.
+ *
+ * Design highlights
+ * - Tasks are declared once in a constant table with period and offset in
+ *   minor frames. @ref SoftwareTimer_CyclicBuild turns it into a frame
+ *   table: one bit mask of tasks per minor frame of the major frame. The
+ *   frame table can be built at startup or generated offline and kept as a
+ *   constant in flash.
+ * - Each minor frame costs one deadline comparison, one table lookup and an
+ *   index increment, independent of the number of tasks.
+ * - Frame starts follow the clock on a fixed grid (previous start plus the
+ *   minor frame), so the schedule does not drift with execution time.
+ * - A frame whose tasks are still running when the next frame should start
+ *   is an overrun. Overruns are counted and the index of the last overrun
+ *   frame is kept; the following frames are started late but keep the grid.
+ * - Periods must be harmonic: every period divides the longest one, which
+ *   is the major frame. Up to @ref SOFTWARETIMER_CYCLIC_MAX_TASKS tasks.
+ *
+ * Usage example:
+ * @code
+ * static const SoftwareTimer_CyclicTask tasks[] = {
+ *     {Control_Step, NULL, 1, 0},   // every frame
+ *     {Sensors_Read, NULL, 2, 1},   // odd frames
+ *     {Telemetry_Send, NULL, 8, 3}, // once per major frame
+ * };
+ * static uint32_t frames[8];
+ * static SoftwareTimer_Cyclic executive;
+ *
+ * uint32_t frameCount = SoftwareTimer_CyclicBuild(tasks, 3, frames, 8);
+ * SoftwareTimer_CyclicStart(&executive, tasks, frames, frameCount, SOFTWARETIMER_MS(5));
+ *
+ * while (1) {
+ *     Cpu_SleepFor(SoftwareTimer_CyclicPoll(&executive));
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_CYCLIC_H
+#define SOFTWARE_TIMER_CYCLIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_cyclic Cyclic executive
+ * @brief Time-triggered execution from a static frame table
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_CYCLIC_MAX_TASKS
+ * @brief Maximum number of tasks, the width of a frame mask
+ */
+#define SOFTWARETIMER_CYCLIC_MAX_TASKS 32u
+
+/**
+ * @def SOFTWARETIMER_CYCLIC_NO_OVERRUN
+ * @brief Value of lastOverrun before the first overrun
+ */
+#define SOFTWARETIMER_CYCLIC_NO_OVERRUN UINT32_MAX
+
+/**
+ * @typedef SoftwareTimer_CyclicFunction
+ * @brief Function of a cyclic task
+ *
+ * @param[in] context User data from the task declaration
+ */
+typedef void (*SoftwareTimer_CyclicFunction)(void * context);
+
+/**
+ * @struct SoftwareTimer_CyclicTask
+ * @brief Declaration of a cyclic task
+ *
+ * Tasks of one frame run in the order of the declaration table.
+ */
+typedef struct {
+    SoftwareTimer_CyclicFunction function; /**< Function run in the task's frames */
+    void * context; /**< User data passed to function */
+    uint32_t period; /**< Period in minor frames, at least 1 */
+    uint32_t offset; /**< First frame of the task, less than period */
+} SoftwareTimer_CyclicTask;
+
+/**
+ * @struct SoftwareTimer_Cyclic
+ * @brief Cyclic executive state structure
+ */
+typedef struct {
+    const SoftwareTimer_CyclicTask * tasks; /**< Task declarations */
+    const uint32_t * frames; /**< Task mask of every minor frame */
+    uint32_t frameCount; /**< Minor frames per major frame */
+    uint32_t minorFrame; /**< Length of a minor frame in clock ticks */
+    uint32_t frame; /**< Index of the next frame to run */
+    uint32_t next; /**< Start time of the next frame */
+    uint32_t overruns; /**< Number of frames that ran into the next frame */
+    uint32_t lastOverrun; /**< Index of the last overrun frame, SOFTWARETIMER_CYCLIC_NO_OVERRUN if none */
+} SoftwareTimer_Cyclic;
+
+/**
+ * @brief Builds the frame table of a task set
+ *
+ * Frame f of the major frame runs task i if (f - offset) is a multiple of
+ * the task's period. Bit i of a mask stands for task i.
+ *
+ * @param[in] tasks Task declarations. Must not be NULL.
+ * @param[in] count Number of tasks, 1 to @ref SOFTWARETIMER_CYCLIC_MAX_TASKS.
+ * @param[out] frames Storage for the frame table. Must not be NULL.
+ * @param[in] capacity Number of masks @p frames can hold.
+ *
+ * @return Number of minor frames in the major frame (the longest period)
+ * @retval 0 if a period is 0, an offset is not less than its period, the
+ *         periods are not harmonic or the table does not fit
+ */
+uint32_t SoftwareTimer_CyclicBuild(const SoftwareTimer_CyclicTask * tasks, uint32_t count, uint32_t * frames, uint32_t capacity);
+
+/**
+ * @brief Starts the executive; frame 0 is due immediately
+ *
+ * @param[out] cyclic Pointer to executive structure. Must not be NULL.
+ * @param[in] tasks Task declarations the frame table was built from. Must not be NULL.
+ * @param[in] frames Frame table. Must not be NULL.
+ * @param[in] frameCount Number of frames, as returned by @ref SoftwareTimer_CyclicBuild. Greater than 0.
+ * @param[in] minorFrame Length of a minor frame in clock ticks, 1 to INT32_MAX.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_CyclicStart(SoftwareTimer_Cyclic * cyclic, const SoftwareTimer_CyclicTask * tasks, const uint32_t * frames, uint32_t frameCount,
+                               uint32_t minorFrame);
+
+/**
+ * @brief Runs the next frame if its start time has come
+ *
+ * Runs at most one frame per call, so that a caller which fell behind
+ * catches up frame by frame without skipping any.
+ *
+ * @param[in,out] cyclic Pointer to executive. Must not be NULL.
+ *
+ * @return Number of ticks until the next frame is due, 0 if it is already
+ *         due (after an overrun)
+ *
+ * @note Reads the clock once, and once more after running a frame to
+ *       detect an overrun.
+ */
+uint32_t SoftwareTimer_CyclicPoll(SoftwareTimer_Cyclic * cyclic);
+
+/** @} */ // end of software_timer_cyclic group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_CYCLIC_H
@@ -0,0 +1,168 @@
+/**
+ * @file software_timer_edf.h
+ * @brief Earliest-deadline-first job executor
+ * @author Richard Kubíček
+ *
+ * Jobs are submitted with a relative deadline and an estimated execution
+ * time (cost). The executor always runs the pending job with the earliest
+ * deadline. Under EDF a set of jobs that is feasible at all is feasible in
+ * EDF order, which plain FIFO dispatch does not guarantee.
+ *
+ * Design highlights
+ * - Pending jobs are kept in a binary min-heap over caller-provided storage,
+ *   O(log n) submit and dispatch, no dynamic allocation.
+ * - Deadlines are stored as @ref SoftwareTimer instances and compared with
+ *   overflow-safe arithmetic. Relative deadlines must not exceed INT32_MAX.
+ * - Admission control rejects a job when, based on the estimated costs,
+ *   accepting it could make it or an already admitted job miss its deadline.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Job * storage[16];
+ * static SoftwareTimer_Edf edf;
+ * static SoftwareTimer_Job frameJob;
+ *
+ * SoftwareTimer_EdfInit(&edf, storage, 16);
+ * SoftwareTimer_JobInit(&frameJob, encode_frame, &frame, 3); // ~3 ticks of work
+ *
+ * if (SoftwareTimer_EdfSubmit(&edf, &frameJob, 20) != SOFTWARETIMER_EDF_ACCEPTED) {
+ *     drop_frame();
+ * }
+ *
+ * while (SoftwareTimer_EdfRunNext(&edf)) {
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_EDF_H
+#define SOFTWARE_TIMER_EDF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_edf EDF executor
+ * @brief Earliest-deadline-first dispatch with admission control
+ * @{
+ */
+
+typedef struct SoftwareTimer_Job SoftwareTimer_Job;
+
+/**
+ * @typedef SoftwareTimer_JobFunction
+ * @brief Job body called by @ref SoftwareTimer_EdfRunNext
+ *
+ * @param[in,out] job Job being executed. It is no longer pending and may be
+ *                    submitted again from its own body.
+ */
+typedef void (*SoftwareTimer_JobFunction)(SoftwareTimer_Job * job);
+
+/**
+ * @struct SoftwareTimer_Job
+ * @brief Job submitted to @ref SoftwareTimer_Edf
+ */
+struct SoftwareTimer_Job {
+    SoftwareTimer deadline; /**< Expires at the job's absolute deadline; set on submit */
+    uint32_t cost; /**< Estimated execution time in clock ticks */
+    SoftwareTimer_JobFunction function; /**< Job body */
+    void * context; /**< User data for the job body */
+};
+
+/**
+ * @struct SoftwareTimer_Edf
+ * @brief Executor state structure
+ */
+typedef struct {
+    SoftwareTimer_Job ** heap; /**< Caller-provided heap storage, earliest deadline at index 0 */
+    uint32_t capacity; /**< Number of elements in heap storage */
+    uint32_t count; /**< Number of pending jobs */
+    uint32_t backlog; /**< Sum of estimated costs of pending jobs */
+} SoftwareTimer_Edf;
+
+/**
+ * @enum SoftwareTimer_EdfResult
+ * @brief Result of @ref SoftwareTimer_EdfSubmit
+ */
+typedef enum {
+    SOFTWARETIMER_EDF_ACCEPTED, /**< Job is pending */
+    SOFTWARETIMER_EDF_FULL, /**< Heap storage is exhausted */
+    SOFTWARETIMER_EDF_REJECTED /**< Admission control predicts a deadline miss */
+} SoftwareTimer_EdfResult;
+
+/**
+ * @brief Initializes an executor without pending jobs
+ *
+ * @param[out] edf Pointer to executor structure. Must not be NULL.
+ * @param[in] storage Heap storage of @p capacity elements. Must not be NULL.
+ * @param[in] capacity Maximum number of pending jobs.
+ */
+void SoftwareTimer_EdfInit(SoftwareTimer_Edf * edf, SoftwareTimer_Job ** storage, uint32_t capacity);
+
+/**
+ * @brief Initializes a job
+ *
+ * @param[out] job Pointer to job structure. Must not be NULL.
+ * @param[in] function Job body. Must not be NULL.
+ * @param[in] context User data available to the body as job->context.
+ * @param[in] cost Estimated execution time in clock ticks.
+ */
+void SoftwareTimer_JobInit(SoftwareTimer_Job * job, SoftwareTimer_JobFunction function, void * context, uint32_t cost);
+
+/**
+ * @brief Submits a job with a deadline relative to now
+ *
+ * Admission control uses a sufficient test based on the estimated costs:
+ * - the pending work with an earlier or equal deadline plus the job's own
+ *   cost must fit before the job's deadline, and
+ * - every pending job with a later deadline that currently fits must still
+ *   fit when all pending work plus the new job runs first.
+ *
+ * @param[in,out] edf Pointer to executor. Must not be NULL.
+ * @param[in,out] job Pointer to initialized job that is not pending. Must not be NULL.
+ * @param[in] deadline Relative deadline in clock ticks, at most INT32_MAX.
+ *
+ * @return Admission result; only an accepted job is pending
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @note Reads the clock once. The admission test walks the pending jobs, O(n).
+ */
+SoftwareTimer_EdfResult SoftwareTimer_EdfSubmit(SoftwareTimer_Edf * edf, SoftwareTimer_Job * job, uint32_t deadline);
+
+/**
+ * @brief Runs the pending job with the earliest deadline
+ *
+ * The job is removed from the executor before its body runs. A job whose
+ * deadline already passed still runs; check
+ * @ref SoftwareTimer_IsExpired on job->deadline to detect the miss.
+ *
+ * @param[in,out] edf Pointer to executor. Must not be NULL.
+ *
+ * @return true if a job was run
+ * @return false if no job was pending
+ *
+ * @note Does not read the clock.
+ */
+bool SoftwareTimer_EdfRunNext(SoftwareTimer_Edf * edf);
+
+/**
+ * @brief Returns number of pending jobs
+ *
+ * @param[in] edf Pointer to executor. Must not be NULL.
+ *
+ * @return Number of pending jobs
+ */
+uint32_t SoftwareTimer_EdfPending(const SoftwareTimer_Edf * edf);
+
+/** @} */ // end of software_timer_edf group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_EDF_H
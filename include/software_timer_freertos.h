@@ -0,0 +1,142 @@
+/**
+ * @file software_timer_freertos.h
+ * @brief FreeRTOS tick-hook and tickless-idle integration of the timer manager
+ * @author Richard Kubíček
+ *
+ * Lets a FreeRTOS application use one timer mechanism instead of mixing RTOS
+ * software timers with this library:
+ * - The FreeRTOS tick count is the library clock source.
+ * - The tick hook compares the tick count with the manager's earliest
+ *   deadline (one comparison per tick) and wakes the processing task only
+ *   when an entry is due. Callbacks run in that task, not in the tick ISR.
+ * - With tickless idle, the expected idle time is clamped to the manager's
+ *   next deadline, so the kernel never sleeps past a pending entry.
+ *
+ * The implementation is compiled only when @c SOFTWARETIMER_FREERTOS is
+ * defined, so the module costs nothing in non-FreeRTOS builds. It requires
+ * 32-bit ticks (@c configUSE_16_BIT_TICKS 0) and @c configUSE_TICK_HOOK 1.
+ * It builds unchanged with the FreeRTOS POSIX/Linux simulator port, which
+ * lets the integration run on a Linux host; the unit tests exercise it
+ * against a stub of the few kernel calls it uses (@c test/freertos, build
+ * with @c -DSOFTWARETIMER_FREERTOS @c -Itest/freertos).
+ *
+ * Integration example:
+ * @code
+ * // FreeRTOSConfig.h
+ * #define configUSE_TICK_HOOK 1
+ * #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(x) \
+ *     (x) = SoftwareTimer_FreeRtosExpectedIdle(x)
+ *
+ * // Application
+ * void vApplicationTickHook(void)
+ * {
+ *     SoftwareTimer_FreeRtosTickHook();
+ * }
+ *
+ * static void timer_task(void * arg)
+ * {
+ *     SoftwareTimer_FreeRtosTaskLoop();
+ * }
+ *
+ * SoftwareTimer_FreeRtosInit();
+ * xTaskCreate(timer_task, "swtimer", 256, NULL, 3, &handle);
+ * SoftwareTimer_FreeRtosSetTask(handle);
+ * SoftwareTimer_FreeRtosStart(&entry, pdMS_TO_TICKS(100));
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_FREERTOS_H
+#define SOFTWARE_TIMER_FREERTOS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include "software_timer_manager.h"
+#include "task.h"
+
+/**
+ * @defgroup software_timer_freertos FreeRTOS integration
+ * @brief Tick hook and tickless idle driven by the timer manager
+ * @{
+ */
+
+/**
+ * @brief Initializes the library clock and the shared manager
+ *
+ * Registers the FreeRTOS tick count as clock source via
+ * @ref SoftwareTimer_Init. Call before the scheduler starts.
+ */
+void SoftwareTimer_FreeRtosInit(void);
+
+/**
+ * @brief Sets the task that processes expired entries
+ *
+ * @param[in] task Handle of the task running @ref SoftwareTimer_FreeRtosTaskLoop.
+ */
+void SoftwareTimer_FreeRtosSetTask(TaskHandle_t task);
+
+/**
+ * @brief Arms a one-shot entry in the shared manager
+ *
+ * Task context only. Safe against the tick hook.
+ *
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] ticks Interval in RTOS ticks.
+ */
+void SoftwareTimer_FreeRtosStart(SoftwareTimer_Entry * entry, uint32_t ticks);
+
+/**
+ * @brief Arms a periodic entry in the shared manager
+ *
+ * Task context only. Safe against the tick hook.
+ *
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] ticks Period in RTOS ticks, greater than 0.
+ */
+void SoftwareTimer_FreeRtosStartPeriodic(SoftwareTimer_Entry * entry, uint32_t ticks);
+
+/**
+ * @brief Disarms an entry in the shared manager
+ *
+ * Task context only. Safe against the tick hook.
+ *
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ */
+void SoftwareTimer_FreeRtosStop(SoftwareTimer_Entry * entry);
+
+/**
+ * @brief Tick hook body
+ *
+ * Call from @c vApplicationTickHook. Notifies the processing task when the
+ * earliest entry is due.
+ */
+void SoftwareTimer_FreeRtosTickHook(void);
+
+/**
+ * @brief Clamps the tickless idle time to the next deadline
+ *
+ * Use from @c configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING.
+ *
+ * @param[in] expected Idle time computed by the kernel, in ticks.
+ *
+ * @return Smaller of @p expected and the ticks until the earliest deadline
+ */
+TickType_t SoftwareTimer_FreeRtosExpectedIdle(TickType_t expected);
+
+/**
+ * @brief Processing task body
+ *
+ * Waits for notifications from the tick hook and fires expired entries.
+ * Callbacks run in this task and may arm or stop entries. Never returns.
+ */
+void SoftwareTimer_FreeRtosTaskLoop(void);
+
+/** @} */ // end of software_timer_freertos group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_FREERTOS_H
@@ -0,0 +1,209 @@
+/**
+ * @file software_timer_fsm.h
+ * @brief State-machine timeouts with one timer per machine
+ * @author Richard Kubíček
+ *
+ * Protocol state machines usually need a timeout in most states ("no answer
+ * within 200 ms"), but only in the state they are currently in. Instead of
+ * one @ref SoftwareTimer per state, a machine owns a single timer slot that
+ * is re-armed on every state entry from a per-state interval table.
+ *
+ * Design highlights
+ * - The interval table and the timeout callback live in a constant
+ *   @ref SoftwareTimer_FsmTable shared by all instances of the same machine
+ *   type. An instance stores one @ref SoftwareTimer_Entry, a table pointer
+ *   and the current state.
+ * - With a manager in the table, expiry is handled by
+ *   @ref SoftwareTimer_ManagerProcess and costs nothing for machines that are
+ *   not due. Without a manager, @ref SoftwareTimer_FsmPoll checks the slot.
+ * - Arming cost: with only a manager, every state entry is a sorted insert
+ *   into the manager list, O(n) in the armed entries, so with thousands of
+ *   machines every transition walks thousands of entries. Give the table
+ *   per-state queues (@ref SoftwareTimer_FsmQueue) to make it O(1): all
+ *   machines in a state share that state's timeout, so appending them in
+ *   arming order keeps each queue sorted by deadline, and only one manager
+ *   entry per state (armed no later than the queue head) is linked in the
+ *   manager.
+ * - The timeout callback typically enters the next state, which re-arms the
+ *   slot with that state's interval.
+ *
+ * Usage example:
+ * @code
+ * enum { LINK_IDLE, LINK_CONNECTING, LINK_UP, LINK_STATES };
+ *
+ * static const uint32_t linkTimeouts[LINK_STATES] = {
+ *     SOFTWARETIMER_FSM_NO_TIMEOUT, 200, 5000
+ * };
+ *
+ * static void link_timeout(SoftwareTimer_Fsm * fsm, uint32_t state)
+ * {
+ *     SoftwareTimer_FsmEnter(fsm, LINK_IDLE); // connect or keep-alive timed out
+ * }
+ *
+ * static SoftwareTimer_FsmQueue linkQueues[LINK_STATES];
+ * static const SoftwareTimer_FsmTable linkTable = {linkTimeouts, LINK_STATES, link_timeout, &manager, linkQueues};
+ * static SoftwareTimer_Fsm links[1000];
+ *
+ * SoftwareTimer_FsmQueuesInit(&linkTable); // once, before the first machine
+ * SoftwareTimer_FsmInit(&links[i], &linkTable, &connections[i], LINK_IDLE);
+ * SoftwareTimer_FsmEnter(&links[i], LINK_CONNECTING); // times out after 200 ticks
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_FSM_H
+#define SOFTWARE_TIMER_FSM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include "software_timer_manager.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_fsm State-machine timeouts
+ * @brief Per-state timeouts sharing one timer slot per machine
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_FSM_NO_TIMEOUT
+ * @brief Interval table value for states without a timeout
+ */
+#define SOFTWARETIMER_FSM_NO_TIMEOUT UINT32_MAX
+
+typedef struct SoftwareTimer_Fsm SoftwareTimer_Fsm;
+typedef struct SoftwareTimer_FsmQueue SoftwareTimer_FsmQueue;
+
+/**
+ * @typedef SoftwareTimer_FsmTimeoutCallback
+ * @brief Function called when a machine stays in a state for its timeout
+ *
+ * The slot is already disarmed when the callback runs; entering a state
+ * (including the same one) re-arms it.
+ *
+ * @param[in,out] fsm Machine that timed out
+ * @param[in] state State that timed out
+ */
+typedef void (*SoftwareTimer_FsmTimeoutCallback)(SoftwareTimer_Fsm * fsm, uint32_t state);
+
+/**
+ * @struct SoftwareTimer_FsmTable
+ * @brief Constant description shared by all machines of one type
+ */
+typedef struct {
+    const uint32_t * timeouts; /**< Timeout per state in clock ticks (at most INT32_MAX) or @ref SOFTWARETIMER_FSM_NO_TIMEOUT */
+    uint32_t stateCount; /**< Number of elements in timeouts */
+    SoftwareTimer_FsmTimeoutCallback onTimeout; /**< Called when a state times out */
+    SoftwareTimer_Manager * manager; /**< Manager firing the timeouts, or NULL to use @ref SoftwareTimer_FsmPoll */
+    SoftwareTimer_FsmQueue * queues; /**< stateCount queues for O(1) state entry with a manager, or NULL to arm the slots in the manager */
+} SoftwareTimer_FsmTable;
+
+/**
+ * @struct SoftwareTimer_FsmQueue
+ * @brief Machines armed in one state, in deadline order
+ *
+ * Initialized by @ref SoftwareTimer_FsmQueuesInit. The queue entry is the
+ * only one linked in the manager for the state; it may fire before the head
+ * is due (after the head machine left the state), and then only re-arms.
+ */
+struct SoftwareTimer_FsmQueue {
+    SoftwareTimer_Entry entry; /**< Manager entry armed no later than the head's deadline. Must stay the first member */
+    const SoftwareTimer_FsmTable * table; /**< Table owning the queue */
+    SoftwareTimer_Entry * head; /**< Slot of the machine armed first */
+    SoftwareTimer_Entry * tail; /**< Slot of the machine armed last */
+    SoftwareTimer_Entry * cursor; /**< Last slot of the batch being dispatched, NULL otherwise */
+};
+
+/**
+ * @struct SoftwareTimer_Fsm
+ * @brief Machine instance
+ *
+ * User data passed to @ref SoftwareTimer_FsmInit is available as
+ * fsm->slot.context.
+ */
+struct SoftwareTimer_Fsm {
+    SoftwareTimer_Entry slot; /**< Timeout of the current state. Must stay the first member */
+    const SoftwareTimer_FsmTable * table; /**< Shared machine description */
+    uint32_t state; /**< Current state */
+};
+
+/**
+ * @brief Initializes the per-state queues of a table
+ *
+ * Call once before the first @ref SoftwareTimer_FsmInit with the table. The
+ * queues, like the machines, belong to the context that runs
+ * @ref SoftwareTimer_ManagerProcess.
+ *
+ * @param[in] table Machine description with a manager and queues. Must not be NULL.
+ */
+void SoftwareTimer_FsmQueuesInit(const SoftwareTimer_FsmTable * table);
+
+/**
+ * @brief Initializes a machine and enters its initial state
+ *
+ * @param[out] fsm Pointer to machine structure. Must not be NULL.
+ * @param[in] table Machine description. Must not be NULL and must outlive
+ *                  the machine; its queues, if any, must be initialized.
+ * @param[in] context User data, available as fsm->slot.context.
+ * @param[in] initialState First state, less than table->stateCount.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_FsmInit(SoftwareTimer_Fsm * fsm, const SoftwareTimer_FsmTable * table, void * context, uint32_t initialState);
+
+/**
+ * @brief Enters a state and re-arms the timeout slot
+ *
+ * The previous timeout is cancelled. Entering the current state again
+ * restarts its timeout.
+ *
+ * @param[in,out] fsm Pointer to machine. Must not be NULL.
+ * @param[in] state New state, less than table->stateCount.
+ *
+ * @note Reads the clock once if the state has a timeout. With queues the
+ *       cost is O(1), plus one @ref SoftwareTimer_ManagerStart when the
+ *       queue of the state was empty. With a manager but no queues it is
+ *       that of @ref SoftwareTimer_ManagerStart, O(n) in the armed entries.
+ */
+void SoftwareTimer_FsmEnter(SoftwareTimer_Fsm * fsm, uint32_t state);
+
+/**
+ * @brief Returns the current state
+ *
+ * @param[in] fsm Pointer to machine. Must not be NULL.
+ *
+ * @return Current state
+ */
+uint32_t SoftwareTimer_FsmState(const SoftwareTimer_Fsm * fsm);
+
+/**
+ * @brief Fires the timeout of a machine without a manager
+ *
+ * Calls the timeout callback once if the current state has timed out.
+ *
+ * @param[in,out] fsm Pointer to machine whose table has no manager. Must not be NULL.
+ *
+ * @return true if the callback was called
+ */
+bool SoftwareTimer_FsmPoll(SoftwareTimer_Fsm * fsm);
+
+/**
+ * @brief Cancels the timeout of the current state
+ *
+ * Call before the machine's storage is released when a manager is used.
+ * The state is kept; the next @ref SoftwareTimer_FsmEnter arms again.
+ *
+ * @param[in,out] fsm Pointer to machine. Must not be NULL.
+ */
+void SoftwareTimer_FsmStop(SoftwareTimer_Fsm * fsm);
+
+/** @} */ // end of software_timer_fsm group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_FSM_H
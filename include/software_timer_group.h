@@ -0,0 +1,161 @@
+/**
+ * @file software_timer_group.h
+ * @brief Delta-compressed timer groups with 16-bit offsets from a shared base
+ * @author Richard Kubíček
+ *
+ * Timers that are armed in cohorts with short intervals (per-sensor
+ * timeouts, per-channel retries) do not need a full @ref SoftwareTimer each.
+ * A group stores one 32-bit base time; every member stores its start as a
+ * 16-bit offset from the base and its interval in 16 bits, 4 bytes per
+ * timer instead of 12.
+ *
+ * Design highlights
+ * - Expiry checks use the same overflow-safe unsigned arithmetic as
+ *   @ref SoftwareTimer: start = base + offset.
+ * - The base only moves when a member is armed more than 65535 ticks after
+ *   it (lazy rebase). The rebase moves the base to the oldest still running
+ *   member; members that already expired are pinned to "just expired" so
+ *   that they keep reporting expiration.
+ * - Members are packed in one array, so scanning for expired members walks
+ *   contiguous memory.
+ * - Intervals are limited to @ref SOFTWARETIMER_GROUP_MAX_INTERVAL ticks.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_GroupMember sensorTimeouts[64];
+ * static SoftwareTimer_Group sensors;
+ *
+ * SoftwareTimer_GroupInit(&sensors, sensorTimeouts, 64);
+ * SoftwareTimer_GroupSet(&sensors, channel, 250);
+ *
+ * for (uint32_t i = SoftwareTimer_GroupNextExpired(&sensors, 0); i != SOFTWARETIMER_GROUP_NONE;
+ *      i = SoftwareTimer_GroupNextExpired(&sensors, i + 1)) {
+ *     SoftwareTimer_GroupStop(&sensors, i);
+ *     Sensor_Timeout(i);
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_GROUP_H
+#define SOFTWARE_TIMER_GROUP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_group Timer groups
+ * @brief Compact timers sharing a base time
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_GROUP_MAX_INTERVAL
+ * @brief Longest interval of a group member in clock ticks
+ */
+#define SOFTWARETIMER_GROUP_MAX_INTERVAL 65534u
+
+/**
+ * @def SOFTWARETIMER_GROUP_NONE
+ * @brief Returned by @ref SoftwareTimer_GroupNextExpired when no member expired
+ */
+#define SOFTWARETIMER_GROUP_NONE UINT32_MAX
+
+/**
+ * @struct SoftwareTimer_GroupMember
+ * @brief Packed timer of a group
+ */
+typedef struct {
+    uint16_t offset; /**< Start time relative to the group base */
+    uint16_t interval; /**< Interval in clock ticks, UINT16_MAX while stopped */
+} SoftwareTimer_GroupMember;
+
+/**
+ * @struct SoftwareTimer_Group
+ * @brief Group state structure
+ */
+typedef struct {
+    uint32_t base; /**< Time the member offsets are relative to */
+    SoftwareTimer_GroupMember * members; /**< Caller-provided member storage */
+    uint32_t count; /**< Number of members */
+} SoftwareTimer_Group;
+
+/**
+ * @brief Initializes a group with all members stopped
+ *
+ * @param[out] group Pointer to group structure. Must not be NULL.
+ * @param[out] members Storage for @p count members. Must not be NULL.
+ * @param[in] count Number of members.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_GroupInit(SoftwareTimer_Group * group, SoftwareTimer_GroupMember * members, uint32_t count);
+
+/**
+ * @brief Sets and starts a member
+ *
+ * @param[in,out] group Pointer to group. Must not be NULL.
+ * @param[in] index Member index, less than the member count.
+ * @param[in] interval Interval in clock ticks, at most
+ *                     @ref SOFTWARETIMER_GROUP_MAX_INTERVAL.
+ *
+ * @note Reads the clock once. O(1) unless the base has to move, which
+ *       touches every member once and happens at most once per 65535 ticks.
+ */
+void SoftwareTimer_GroupSet(SoftwareTimer_Group * group, uint32_t index, uint16_t interval);
+
+/**
+ * @brief Stops a member
+ *
+ * @param[in,out] group Pointer to group. Must not be NULL.
+ * @param[in] index Member index, less than the member count.
+ */
+void SoftwareTimer_GroupStop(SoftwareTimer_Group * group, uint32_t index);
+
+/**
+ * @brief Checks if a member has expired
+ *
+ * Like @ref SoftwareTimer_IsExpired, keeps returning true until the member
+ * is set again or stopped.
+ *
+ * @param[in] group Pointer to group. Must not be NULL.
+ * @param[in] index Member index, less than the member count.
+ *
+ * @return true if the member is running and its interval has elapsed
+ */
+bool SoftwareTimer_GroupIsExpired(const SoftwareTimer_Group * group, uint32_t index);
+
+/**
+ * @brief Returns remaining time of a member
+ *
+ * @param[in] group Pointer to group. Must not be NULL.
+ * @param[in] index Member index, less than the member count.
+ *
+ * @return Ticks until expiration, 0 if expired or stopped
+ */
+uint32_t SoftwareTimer_GroupRemaining(const SoftwareTimer_Group * group, uint32_t index);
+
+/**
+ * @brief Finds the next expired member
+ *
+ * @param[in] group Pointer to group. Must not be NULL.
+ * @param[in] from Index to start the scan at.
+ *
+ * @return Index of the first expired member at or after @p from
+ * @retval SOFTWARETIMER_GROUP_NONE if there is none
+ *
+ * @note Reads the clock once per call.
+ */
+uint32_t SoftwareTimer_GroupNextExpired(const SoftwareTimer_Group * group, uint32_t from);
+
+/** @} */ // end of software_timer_group group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_GROUP_H
@@ -0,0 +1,160 @@
+/**
+ * @file software_timer_iouring.h
+ * @brief io_uring timeout backend for the timer manager, with timerfd fallback
+ * @author Richard Kubíček
+ *
+ * An io_uring event loop sleeps in @c io_uring_submit_and_wait, so the
+ * manager's earliest deadline has to be a timeout request in the same ring.
+ * This module owns that request for one @ref SoftwareTimer_Manager:
+ * - It submits an @c IORING_OP_TIMEOUT with @c IORING_TIMEOUT_ABS for the
+ *   earliest deadline, as absolute @c CLOCK_MONOTONIC time.
+ * - When the earliest deadline changes, the pending timeout is moved with a
+ *   timeout update; when no entry is left it is removed. A timeout that is
+ *   still valid is left alone, so a re-arm without changes costs no SQE.
+ * - Its completion processes the manager. Completions of stale timeouts
+ *   are told apart from the current one by their user data.
+ * - When @c io_uring_queue_init fails (kernel without io_uring, or io_uring
+ *   disabled by policy) it falls back to a timerfd armed with
+ *   @ref SoftwareTimer_TimerfdArm, which the loop polls instead.
+ *
+ * SQEs are only prepared; the event loop submits them with its own I/O.
+ * User data values from @c tag to @c tag + @c UINT32_MAX are reserved for
+ * the module's requests.
+ *
+ * The implementation is compiled only when @c SOFTWARETIMER_IOURING is
+ * defined on Linux and requires liburing. The unit tests exercise it against
+ * a stub of the few liburing calls it uses (@c test/liburing, build with
+ * @c -DSOFTWARETIMER_IOURING @c -Itest/liburing).
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Uring uring;
+ *
+ * SoftwareTimer_UringInit(&uring, &manager, 64, TIMER_TAG);
+ * for (;;) {
+ *     SoftwareTimer_UringRearm(&uring); // before every wait
+ *     if (uring.timerfd < 0) {
+ *         struct io_uring_cqe * cqe;
+ *
+ *         io_uring_submit_and_wait(&uring.ring, 1);
+ *         while (io_uring_peek_cqe(&uring.ring, &cqe) == 0) {
+ *             if (!SoftwareTimer_UringHandleCqe(&uring, cqe)) {
+ *                 handle_io(cqe);
+ *             }
+ *             io_uring_cqe_seen(&uring.ring, cqe);
+ *         }
+ *     } else {
+ *         // Fallback: the timerfd is one more descriptor of the poll set
+ *         poll_io_and(uring.timerfd);
+ *         SoftwareTimer_UringHandleTimerfd(&uring);
+ *     }
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_IOURING_H
+#define SOFTWARE_TIMER_IOURING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer_manager.h"
+#include "software_timer_posix.h"
+#include <liburing.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_iouring io_uring backend
+ * @brief Manager deadline as an io_uring timeout, timerfd fallback
+ * @{
+ */
+
+/**
+ * @struct SoftwareTimer_Uring
+ * @brief io_uring backend state structure
+ */
+typedef struct {
+    struct io_uring ring; /**< Ring shared with the event loop's I/O, valid when timerfd is negative */
+    int timerfd; /**< Fallback timerfd, -1 when the ring is used */
+    SoftwareTimer_Manager * manager; /**< Manager processed on expiration */
+    uint64_t tag; /**< User data of update and remove requests; timeouts use tag + sequence */
+    uint32_t sequence; /**< Sequence of the latest timeout request, never 0 */
+    uint32_t generation; /**< Manager list generation the pending timeout was computed from */
+    bool armed; /**< A timeout (or the armed timerfd) for the current deadline is pending */
+    struct __kernel_timespec timeout; /**< Deadline of the latest request, read by the kernel on submission */
+} SoftwareTimer_Uring;
+
+/**
+ * @brief Creates the ring, or the fallback timerfd if that fails
+ *
+ * @param[out] uring Pointer to backend structure. Must not be NULL.
+ * @param[in] manager Manager whose earliest deadline is waited for. Must not be NULL.
+ * @param[in] entries Submission queue size passed to @c io_uring_queue_init.
+ * @param[in] tag First user data value reserved for the module, at most
+ *                @c UINT64_MAX - @c UINT32_MAX.
+ *
+ * @return 0 on success with either backend (check @c timerfd)
+ * @retval -1 if neither could be created, with errno set
+ */
+int SoftwareTimer_UringInit(SoftwareTimer_Uring * uring, SoftwareTimer_Manager * manager, unsigned entries, uint64_t tag);
+
+/**
+ * @brief Releases the ring or the timerfd
+ *
+ * @param[in,out] uring Pointer to backend. Must not be NULL.
+ */
+void SoftwareTimer_UringExit(SoftwareTimer_Uring * uring);
+
+/**
+ * @brief Brings the kernel timeout in line with the earliest deadline
+ *
+ * Prepares a timeout, a timeout update or a timeout remove request, or
+ * programs the fallback timerfd. Does nothing if the pending timeout was
+ * computed from the current entry list. Call it before every wait; it is
+ * cheap when nothing changed. With the ring, a full submission queue is
+ * submitted once to make room.
+ *
+ * @param[in,out] uring Pointer to backend. Must not be NULL.
+ *
+ * @return 0 on success
+ * @retval -1 on error, with errno set (@c EBUSY: no free SQE); the next
+ *         call retries
+ */
+int SoftwareTimer_UringRearm(SoftwareTimer_Uring * uring);
+
+/**
+ * @brief Handles a completion if it belongs to the module
+ *
+ * Processes the manager when the timeout expired. Completions of updates,
+ * removes and cancelled timeouts only update the bookkeeping. The caller
+ * still marks the completion seen.
+ *
+ * @param[in,out] uring Pointer to backend. Must not be NULL.
+ * @param[in] cqe Completion. Must not be NULL.
+ *
+ * @return true if the completion was the module's
+ * @return false if it belongs to the event loop
+ */
+bool SoftwareTimer_UringHandleCqe(SoftwareTimer_Uring * uring, const struct io_uring_cqe * cqe);
+
+/**
+ * @brief Handles a readable fallback timerfd
+ *
+ * Reads the expiration count and processes the manager.
+ *
+ * @param[in,out] uring Pointer to backend using the timerfd. Must not be NULL.
+ *
+ * @return true if the timerfd had expired
+ * @return false if it was not readable
+ */
+bool SoftwareTimer_UringHandleTimerfd(SoftwareTimer_Uring * uring);
+
+/** @} */ // end of software_timer_iouring group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_IOURING_H
@@ -0,0 +1,462 @@
+/**
+ * @file software_timer_manager.h
+ * @brief Callback timer manager with next-deadline query
+ * @author Richard Kubíček
+ *
+ * The manager keeps callback timers (entries) in a list sorted by deadline.
+ * A single call to @ref SoftwareTimer_ManagerProcess reads the clock once,
+ * fires every expired entry and returns the number of ticks until the next
+ * deadline, so the caller can sleep instead of polling every timer.
+ *
+ * Design highlights
+ * - Entries are intrusive and provided by the caller, no dynamic allocation.
+ * - Expiry processing only looks at the head of the list: the cost is
+ *   proportional to the number of expired entries, not to the number of
+ *   armed entries.
+ * - Periodic entries are re-armed from their previous deadline, so the
+ *   period does not drift with processing latency. Repeating entries
+ *   (@ref SoftwareTimer_ManagerStartRepeating) stop themselves after a
+ *   given number of expirations. After a long stall
+ *   (blocking operation, debugger halt, sleep) the missed periods are
+ *   skipped in one step and reported in @c missed, so catching up costs
+ *   one callback per entry, not one per elapsed period.
+ * - Deadlines are compared with the same overflow-safe unsigned arithmetic
+ *   as @ref SoftwareTimer. Intervals must not exceed INT32_MAX ticks so that
+ *   deadlines can be ordered across a clock wrap.
+ * - Entries marked soft have their deadlines rounded up to a manager-wide
+ *   wakeup grid (@ref SoftwareTimer_ManagerSetGrid), in the style of Linux
+ *   @c round_jiffies. Soft timers of unrelated subsystems then expire on the
+ *   same ticks and the system wakes up less often; the grid can be widened
+ *   in power-saving modes without touching the call sites. The aligned
+ *   deadline is also limited to INT32_MAX ticks: soft intervals and periods
+ *   must not exceed INT32_MAX - (grid - 1).
+ * - Without configuration a manager belongs to one execution context.
+ *   Defining @c SOFTWARETIMER_CRITICAL (see software_timer_config_template.h)
+ *   selects interrupt masking, a spinlock or a mutex around arming,
+ *   stopping, @ref SoftwareTimer_ManagerPopExpired, the deadline queries,
+ *   @ref SoftwareTimer_ManagerSetGrid, the walk of
+ *   @ref SoftwareTimer_ManagerVisit and the statistics updates, so entries
+ *   can be armed and stopped from ISRs, other cores or threads. Callbacks
+ *   and statistics snapshots run outside of it. @ref SoftwareTimer_EntryInit, @ref SoftwareTimer_EntrySetSoft
+ *   and @ref SoftwareTimer_EntrySetTag only write the entry and are not
+ *   protected: call them while the entry is not armed.
+ *
+ * Usage example:
+ * @code
+ * static void blink(SoftwareTimer_Entry * entry)
+ * {
+ *     Led_Toggle();
+ * }
+ *
+ * static SoftwareTimer_Manager manager;
+ * static SoftwareTimer_Entry blinkEntry;
+ *
+ * SoftwareTimer_Init(HAL_GetTick);
+ * SoftwareTimer_ManagerInit(&manager);
+ * SoftwareTimer_EntryInit(&blinkEntry, blink, NULL);
+ * SoftwareTimer_ManagerStartPeriodic(&manager, &blinkEntry, 500);
+ *
+ * while (1) {
+ *     uint32_t idle = SoftwareTimer_ManagerProcess(&manager);
+ *     Cpu_SleepFor(idle);
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_MANAGER_H
+#define SOFTWARE_TIMER_MANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_manager Timer manager
+ * @brief Deadline-ordered callback timers
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_NO_DEADLINE
+ * @brief Value returned by the next-deadline queries when nothing is armed
+ */
+#define SOFTWARETIMER_NO_DEADLINE UINT32_MAX
+
+/**
+ * @def SOFTWARETIMER_STATS_BUCKETS
+ * @brief Number of lateness histogram buckets
+ *
+ * Bucket 0 counts expirations processed on time, bucket k counts lateness
+ * of 2^(k-1) to 2^k - 1 ticks and the last bucket everything above.
+ */
+#define SOFTWARETIMER_STATS_BUCKETS 16u
+
+/**
+ * @def SOFTWARETIMER_VISIT_BATCH
+ * @brief Entries copied per critical section by @ref SoftwareTimer_ManagerVisit
+ *
+ * Bounds the time the walk holds the critical section. The batch lives on
+ * the stack of the caller, one @ref SoftwareTimer_EntryInfo per entry.
+ */
+#ifndef SOFTWARETIMER_VISIT_BATCH
+    #define SOFTWARETIMER_VISIT_BATCH 8u
+#endif
+
+typedef struct SoftwareTimer_Entry SoftwareTimer_Entry;
+
+/**
+ * @typedef SoftwareTimer_Callback
+ * @brief Function called by the manager when an entry expires
+ *
+ * The entry is already removed from (or, for periodic entries, re-armed in)
+ * the manager when the callback runs, so the callback may freely start or
+ * stop any entry including its own.
+ *
+ * @param[in,out] entry Expired entry
+ */
+typedef void (*SoftwareTimer_Callback)(SoftwareTimer_Entry * entry);
+
+/**
+ * @struct SoftwareTimer_Entry
+ * @brief Callback timer managed by @ref SoftwareTimer_Manager
+ *
+ * The deadline of an armed entry is timer.start + timer.interval +
+ * alignment.
+ */
+struct SoftwareTimer_Entry {
+    SoftwareTimer timer; /**< Requested deadline of the entry. timer.evaluated is true while the entry is not armed */
+    uint32_t period; /**< Re-arm period in clock ticks. 0 for one-shot entries */
+    uint32_t missed; /**< Periods skipped before the current expiration of a periodic entry */
+    uint32_t remaining; /**< Expirations left after the current one of a repeating entry, 0 if unlimited or done */
+    uint32_t alignment; /**< Ticks added to the requested deadline by the wakeup grid */
+    bool soft; /**< Deadline may be delayed to the manager's wakeup grid */
+    SoftwareTimer_Callback callback; /**< Function called on expiration */
+    void * context; /**< User data for the callback */
+    SoftwareTimer_Entry * next; /**< Next entry in deadline order */
+    SoftwareTimer_Entry * prev; /**< Previous entry in deadline order */
+#ifdef SOFTWARETIMER_STATS
+    const char * tag; /**< Owner tag shown by introspection, NULL if not set */
+#endif
+};
+
+/**
+ * @struct SoftwareTimer_EntryInfo
+ * @brief State of an armed entry reported by @ref SoftwareTimer_ManagerVisit
+ */
+typedef struct {
+    const SoftwareTimer_Entry * entry; /**< Armed entry, for identification; it may have changed since the report was copied */
+    uint32_t remaining; /**< Ticks until the deadline, 0 if due */
+    uint32_t lateness; /**< Ticks since the deadline of a due entry, 0 otherwise */
+    uint32_t period; /**< Re-arm period in clock ticks, 0 for one-shot entries */
+    const char * tag; /**< Owner tag, NULL if not set or without SOFTWARETIMER_STATS */
+} SoftwareTimer_EntryInfo;
+
+/**
+ * @typedef SoftwareTimer_Visitor
+ * @brief Function called for every armed entry by @ref SoftwareTimer_ManagerVisit
+ *
+ * Runs outside of the manager's critical section and may arm or stop
+ * entries, including those of the visited manager.
+ *
+ * @param[in] info State of the entry, valid during the call only
+ * @param[in] context User data passed to @ref SoftwareTimer_ManagerVisit
+ *
+ * @return true to continue, false to stop the walk
+ */
+typedef bool (*SoftwareTimer_Visitor)(const SoftwareTimer_EntryInfo * info, void * context);
+
+/**
+ * @struct SoftwareTimer_ManagerStats
+ * @brief Manager counters maintained when @c SOFTWARETIMER_STATS is defined
+ *
+ * Counters wrap at UINT32_MAX. They are written by one context at a time
+ * (inside the manager's critical section, or by the owning context without
+ * @c SOFTWARETIMER_CRITICAL) with relaxed atomic stores. Read them through
+ * @ref SoftwareTimer_MetricsSnapshot, which uses relaxed atomic loads and
+ * never locks, from any context.
+ */
+typedef struct {
+    uint32_t active; /**< Number of armed entries */
+    uint32_t expirations; /**< Number of expired entries handed out */
+    uint32_t overruns; /**< Number of @ref SoftwareTimer_ManagerProcess calls exceeding dispatchBudget */
+    uint32_t dispatchBudget; /**< Allowed duration of one @ref SoftwareTimer_ManagerProcess call in ticks, 0 to disable */
+    uint32_t latenessSum; /**< Sum of lateness of all expirations in ticks */
+    uint32_t lateness[SOFTWARETIMER_STATS_BUCKETS]; /**< Log2 histogram of lateness, see @ref SOFTWARETIMER_STATS_BUCKETS */
+} SoftwareTimer_ManagerStats;
+
+/**
+ * @struct SoftwareTimer_Manager
+ * @brief Manager state structure
+ *
+ * @note @c SOFTWARETIMER_STATS changes the layout of this structure. Define
+ *       it for all translation units (compiler command line), not per file.
+ */
+typedef struct {
+    SoftwareTimer_Entry * head; /**< Armed entry with the earliest deadline */
+    uint32_t gridMask; /**< Wakeup grid of soft entries minus one, 0 if disabled */
+    uint32_t generation; /**< Advanced by every change of the list, lets a walk resume after releasing the critical section */
+#ifdef SOFTWARETIMER_STATS
+    SoftwareTimer_ManagerStats stats; /**< Counters for the metrics exporter */
+#endif
+} SoftwareTimer_Manager;
+
+/**
+ * @brief Initializes an empty manager
+ *
+ * @param[out] manager Pointer to manager structure. Must not be NULL.
+ */
+void SoftwareTimer_ManagerInit(SoftwareTimer_Manager * manager);
+
+/**
+ * @brief Initializes an entry in the stopped state
+ *
+ * @param[out] entry Pointer to entry structure. Must not be NULL.
+ * @param[in] callback Function called on expiration. Must not be NULL.
+ * @param[in] context User data available to the callback as entry->context.
+ */
+void SoftwareTimer_EntryInit(SoftwareTimer_Entry * entry, SoftwareTimer_Callback callback, void * context);
+
+/**
+ * @brief Arms a one-shot entry
+ *
+ * Captures the current time and arms the entry to expire after @p interval
+ * ticks. An entry that is already armed is re-armed.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] interval Interval in clock ticks, at most INT32_MAX.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @note Insertion walks the list to keep it sorted, O(number of armed entries).
+ */
+void SoftwareTimer_ManagerStart(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t interval);
+
+/**
+ * @brief Arms a periodic entry
+ *
+ * Like @ref SoftwareTimer_ManagerStart, but after every expiration the entry
+ * is re-armed @p period ticks after its previous deadline. If one or more
+ * further deadlines have also passed by then, the entry expires only once,
+ * is re-armed at the first deadline still in the future and entry->missed
+ * holds the number of skipped deadlines.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] period Period in clock ticks, greater than 0 and at most INT32_MAX.
+ */
+void SoftwareTimer_ManagerStartPeriodic(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t period);
+
+/**
+ * @brief Arms a periodic entry that expires a fixed number of times
+ *
+ * Like @ref SoftwareTimer_ManagerStartPeriodic, but the entry unregisters
+ * itself after its @p count-th expiration instead of being re-armed, for
+ * example for protocol retransmissions that give up after N attempts. Every
+ * callback counts as one expiration, also one that coalesced missed periods.
+ * In the callback, entry->remaining holds the expirations still to come;
+ * on the last one it is 0 and @ref SoftwareTimer_EntryIsActive returns false.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] period Period in clock ticks, greater than 0 and at most INT32_MAX.
+ * @param[in] count Number of expirations. 0 stops the entry.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_ManagerStartRepeating(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t period, uint32_t count);
+
+/**
+ * @brief Arms an entry relative to a given start time
+ *
+ * Like @ref SoftwareTimer_ManagerStart or
+ * @ref SoftwareTimer_ManagerStartPeriodic, but the interval counts from
+ * @p start instead of the current time. Useful when the start was captured
+ * elsewhere, for example in an interrupt or by another thread.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] start Start time as returned by @ref SoftwareTimer_Now.
+ * @param[in] interval First interval in clock ticks, at most INT32_MAX.
+ * @param[in] period Re-arm period in clock ticks, 0 for a one-shot entry.
+ *
+ * @note Does not read the clock.
+ */
+void SoftwareTimer_ManagerStartFrom(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t start, uint32_t interval, uint32_t period);
+
+/**
+ * @brief Disarms an entry
+ *
+ * Stopping an entry that is not armed has no effect.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ *
+ * @note O(1), does not read the clock.
+ */
+void SoftwareTimer_ManagerStop(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry);
+
+/**
+ * @brief Marks an entry as soft or hard
+ *
+ * A soft entry tolerates being delayed to the next point of the manager's
+ * wakeup grid. Entries are hard after @ref SoftwareTimer_EntryInit. Takes
+ * effect when the entry is armed (or re-armed by its period) the next time.
+ *
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ * @param[in] soft true to align the deadlines to the wakeup grid.
+ */
+void SoftwareTimer_EntrySetSoft(SoftwareTimer_Entry * entry, bool soft);
+
+/**
+ * @brief Sets the wakeup grid for soft entries
+ *
+ * Deadlines of soft entries are rounded up to the next multiple of
+ * @p grid ticks of the clock, so soft entries with nearby deadlines expire
+ * together. A periodic soft entry keeps its nominal schedule: the rounding
+ * never accumulates, and periods shorter than the grid are coalesced and
+ * reported in entry->missed. Hard entries are not affected.
+ *
+ * Can be switched at any time, for example to 4 ticks when idle and 64 when
+ * on battery. The new grid applies to deadlines computed after the call;
+ * entries already armed keep their current deadline.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in] grid Power of two up to 2^30 ticks; 0 or 1 disables alignment.
+ *                 Every soft entry armed or re-armed while the grid is set
+ *                 must have an interval of at most INT32_MAX - (grid - 1)
+ *                 ticks, so the aligned deadline stays within INT32_MAX.
+ *
+ * @note O(1), does not read the clock.
+ */
+void SoftwareTimer_ManagerSetGrid(SoftwareTimer_Manager * manager, uint32_t grid);
+
+/**
+ * @brief Checks if an entry is armed
+ *
+ * @param[in] entry Pointer to entry. Must not be NULL.
+ *
+ * @return true if the entry is armed in a manager
+ */
+bool SoftwareTimer_EntryIsActive(const SoftwareTimer_Entry * entry);
+
+/**
+ * @brief Fires all expired entries
+ *
+ * Reads the clock once and calls the callback of every entry whose deadline
+ * has passed, in deadline order. One-shot entries are disarmed before their
+ * callback runs, periodic entries are re-armed before their callback runs.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ *
+ * @return Number of ticks until the next deadline, measured from the time
+ *         read at the start of the call
+ * @retval 0 if an entry is already due, for example one armed by another
+ *         context during the call
+ * @retval SOFTWARETIMER_NO_DEADLINE if no entry is armed
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+uint32_t SoftwareTimer_ManagerProcess(SoftwareTimer_Manager * manager);
+
+/**
+ * @brief Detaches one entry that is due at the given time
+ *
+ * Building block for custom dispatchers (for example executing callbacks on
+ * worker threads). Returns the armed entry with the earliest deadline if that
+ * deadline is not after @p now. One-shot entries are disarmed, periodic
+ * entries are re-armed exactly as in @ref SoftwareTimer_ManagerProcess, but
+ * the callback is not called.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in] now Current time as returned by @ref SoftwareTimer_Now.
+ *
+ * @return Expired entry whose callback is to be called by the caller
+ * @retval NULL if no entry is due
+ *
+ * @note Does not read the clock.
+ */
+SoftwareTimer_Entry * SoftwareTimer_ManagerPopExpired(SoftwareTimer_Manager * manager, uint32_t now);
+
+/**
+ * @brief Returns number of ticks until the earliest deadline
+ *
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ *
+ * @return Number of ticks until the earliest armed entry expires
+ * @retval 0 if an entry is already due
+ * @retval SOFTWARETIMER_NO_DEADLINE if no entry is armed
+ *
+ * @note Reads the clock only when an entry is armed.
+ */
+uint32_t SoftwareTimer_ManagerNextDeadline(const SoftwareTimer_Manager * manager);
+
+/**
+ * @brief Reports every armed entry in deadline order
+ *
+ * Debug introspection, for example from a shell command. The list is
+ * already sorted, so the walk needs no sorting. It copies up to
+ * @ref SOFTWARETIMER_VISIT_BATCH reports at a time inside the critical
+ * section and calls the visitor for them outside of it. The critical
+ * section is never held while the visitor runs, and each hold is bounded
+ * by the batch size, not by the number of entries.
+ *
+ * When the list changes between two batches, the walk resumes after the
+ * last reported deadline. The report is then not an atomic view: an entry
+ * stopped after its batch was copied is still reported, an entry re-armed
+ * to a later deadline may be reported again, and when an already reported
+ * entry leaves a run of equal deadlines, an entry of that run may be
+ * skipped. Unchanged entries with distinct deadlines are reported once.
+ *
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ * @param[in] visitor Function called for each entry. Must not be NULL.
+ * @param[in] context User data passed to @p visitor.
+ *
+ * @return Number of entries reported
+ *
+ * @note Reads the clock once; all entries are reported relative to that
+ *       time. O(number of armed entries) when the list does not change
+ *       during the walk; resuming after a change walks from the head to
+ *       the last reported deadline inside the critical section. Without
+ *       @c SOFTWARETIMER_CRITICAL the caller must serialize the walk with
+ *       other contexts accessing the manager.
+ */
+uint32_t SoftwareTimer_ManagerVisit(const SoftwareTimer_Manager * manager, SoftwareTimer_Visitor visitor, void * context);
+
+#ifdef SOFTWARETIMER_STATS
+/**
+ * @brief Sets the owner tag reported by @ref SoftwareTimer_ManagerVisit
+ *
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ * @param[in] tag Static string naming the owner, or NULL.
+ *
+ * @note Available only when @c SOFTWARETIMER_STATS is defined.
+ */
+void SoftwareTimer_EntrySetTag(SoftwareTimer_Entry * entry, const char * tag);
+
+/**
+ * @brief Sets the dispatch budget of @ref SoftwareTimer_ManagerProcess
+ *
+ * A call that fires at least one entry and takes longer than @p budget
+ * ticks is counted as an overrun. Measuring costs one additional clock read
+ * per such call.
+ *
+ * @param[in,out] manager Pointer to manager. Must not be NULL.
+ * @param[in] budget Allowed duration in clock ticks, 0 disables the measurement.
+ *
+ * @note Available only when @c SOFTWARETIMER_STATS is defined.
+ */
+void SoftwareTimer_ManagerSetBudget(SoftwareTimer_Manager * manager, uint32_t budget);
+#endif
+
+/** @} */ // end of software_timer_manager group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_MANAGER_H
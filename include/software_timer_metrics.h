@@ -0,0 +1,166 @@
+/**
+ * @file software_timer_metrics.h
+ * @brief Timer statistics snapshot with Prometheus text and JSON formatters
+ * @author Richard Kubíček
+ *
+ * With @c SOFTWARETIMER_STATS defined, the core counts clock reads and every
+ * @ref SoftwareTimer_Manager counts armed entries, expirations, lateness and
+ * dispatch budget overruns. This module copies those counters into a
+ * snapshot and formats it for dashboards.
+ *
+ * Design highlights
+ * - Taking a snapshot does not lock the hot path. The manager counters
+ *   have one writer at a time and are written and read with relaxed atomic
+ *   loads and stores, so a snapshot never enters the manager's critical
+ *   section and can be taken from any thread or core, with or without
+ *   @c SOFTWARETIMER_CRITICAL. Each counter is read atomically; counters
+ *   are not read as a group, so a snapshot taken during a dispatch may
+ *   count an expiration in @c expirations but not yet in the histogram.
+ * - Label and string values are escaped for the output format, so any
+ *   engine name or owner tag yields well-formed output.
+ * - Counters are cumulative. Rates such as expirations per second are
+ *   derived by the monitoring system from consecutive scrapes.
+ * - Lateness is exported as a log2 histogram, from which percentiles are
+ *   estimated (Prometheus @c histogram_quantile, or the bucket bounds in the
+ *   JSON output).
+ * - The formatters write into a caller-provided buffer with @c snprintf
+ *   semantics; the text can then be written to a file, a socket or a UART.
+ *
+ * The implementation is compiled only when @c SOFTWARETIMER_STATS is
+ * defined.
+ *
+ * Usage example:
+ * @code
+ * SoftwareTimer_Metrics metrics;
+ * char text[1024];
+ *
+ * SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+ * int length = SoftwareTimer_MetricsFormatPrometheus(&metrics, "main", text, sizeof(text));
+ * if (length > 0 && (size_t) length < sizeof(text)) {
+ *     write(client, text, (size_t) length);
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_METRICS_H
+#define SOFTWARE_TIMER_METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include "software_timer_manager.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_metrics Metrics exporter
+ * @brief Statistics snapshot and text formatters
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_METRICS_OVERFLOW
+ * @brief Percentile value that falls into the last, unbounded lateness bucket
+ */
+#define SOFTWARETIMER_METRICS_OVERFLOW UINT32_MAX
+
+/**
+ * @struct SoftwareTimer_Metrics
+ * @brief Snapshot of the statistics of one manager
+ */
+typedef struct {
+    uint32_t active; /**< Armed entries */
+    uint32_t expirations; /**< Expirations since initialization of the manager */
+    uint32_t overruns; /**< Dispatch budget overruns */
+    uint32_t clockReads; /**< Clock reads of the whole library */
+    uint32_t latenessSum; /**< Sum of lateness in ticks */
+    uint32_t lateness[SOFTWARETIMER_STATS_BUCKETS]; /**< Lateness histogram, see @ref SOFTWARETIMER_STATS_BUCKETS */
+} SoftwareTimer_Metrics;
+
+/**
+ * @brief Copies the counters of a manager
+ *
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ * @param[out] metrics Snapshot. Must not be NULL.
+ *
+ * @note Lock-free: does not enter the manager's critical section and may
+ *       be called from any thread; see the note on threads in the file
+ *       description.
+ */
+void SoftwareTimer_MetricsSnapshot(const SoftwareTimer_Manager * manager, SoftwareTimer_Metrics * metrics);
+
+/**
+ * @brief Estimates a lateness percentile from the histogram
+ *
+ * @param[in] metrics Snapshot. Must not be NULL.
+ * @param[in] percent Percentile, 1 to 100.
+ *
+ * @return Upper bound in ticks of the bucket containing the percentile
+ * @retval 0 if no expiration was recorded
+ * @retval SOFTWARETIMER_METRICS_OVERFLOW if it lies in the last bucket
+ */
+uint32_t SoftwareTimer_MetricsLatenessPercentile(const SoftwareTimer_Metrics * metrics, uint32_t percent);
+
+/**
+ * @brief Formats a snapshot in the Prometheus text exposition format
+ *
+ * Every series carries the label @c engine with the value of @p engine, so
+ * several managers can be exported side by side.
+ *
+ * @param[in] metrics Snapshot. Must not be NULL.
+ * @param[in] engine Label value identifying the manager. Must not be NULL.
+ *                   Backslash, double quote and newline are escaped.
+ * @param[out] buffer Output buffer, NUL-terminated if @p size > 0. May be
+ *                    NULL if @p size is 0.
+ * @param[in] size Size of @p buffer in bytes.
+ *
+ * @return Length of the complete output excluding the terminating NUL; the
+ *         output was truncated if it is not less than @p size
+ */
+int SoftwareTimer_MetricsFormatPrometheus(const SoftwareTimer_Metrics * metrics, const char * engine, char * buffer, size_t size);
+
+/**
+ * @brief Formats a snapshot as a JSON object
+ *
+ * Includes the histogram and p50, p90 and p99 lateness estimates
+ * (@c null when in the last bucket).
+ *
+ * @param[in] metrics Snapshot. Must not be NULL.
+ * @param[in] engine Value of the @c engine member. Must not be NULL.
+ *                   Escaped as a JSON string.
+ * @param[out] buffer Output buffer, NUL-terminated if @p size > 0. May be
+ *                    NULL if @p size is 0.
+ * @param[in] size Size of @p buffer in bytes.
+ *
+ * @return Length of the complete output excluding the terminating NUL; the
+ *         output was truncated if it is not less than @p size
+ */
+int SoftwareTimer_MetricsFormatJson(const SoftwareTimer_Metrics * metrics, const char * engine, char * buffer, size_t size);
+
+/**
+ * @brief Formats the armed entries of a manager as a table
+ *
+ * One line per entry in deadline order with remaining time, lateness and
+ * period in ticks and the owner tag, preceded by a header line. Backslashes
+ * and newlines in tags are escaped so every entry stays on one line.
+ * Intended for a debug shell; built on @ref SoftwareTimer_ManagerVisit.
+ *
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ * @param[out] buffer Output buffer, NUL-terminated if @p size > 0. May be
+ *                    NULL if @p size is 0.
+ * @param[in] size Size of @p buffer in bytes.
+ *
+ * @return Length of the complete output excluding the terminating NUL; the
+ *         output was truncated if it is not less than @p size
+ */
+int SoftwareTimer_MetricsFormatDump(const SoftwareTimer_Manager * manager, char * buffer, size_t size);
+
+/** @} */ // end of software_timer_metrics group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_METRICS_H
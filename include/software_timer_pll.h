@@ -0,0 +1,162 @@
+/**
+ * @file software_timer_pll.h
+ * @brief Periodic timer phase-locked to an external sync pulse
+ * @author Richard Kubíček
+ *
+ * A periodic timer derived from the local tick drifts against an external
+ * reference such as a GPS PPS or a frame-sync line, because the local clock
+ * is never exactly on frequency. This module keeps a periodic timer aligned
+ * with such a reference: every sync pulse timestamp is compared with the
+ * timer's expiration grid and a fixed-point phase-locked loop corrects both
+ * the phase and the period.
+ *
+ * Design highlights
+ * - Expiration times and the period are kept in Q16.16 ticks, so periods
+ *   that are not a whole number of ticks do not accumulate rounding drift.
+ *   Expirations themselves happen on whole ticks, at most one tick after the
+ *   exact grid point.
+ * - The loop is a proportional-integral filter with power-of-two gains:
+ *   @ref SOFTWARETIMER_PLL_PHASE_SHIFT for the phase step and
+ *   @ref SOFTWARETIMER_PLL_FREQUENCY_SHIFT for the period correction. No
+ *   floating point; the only divisions run once per sync pulse.
+ * - The sync period only has to be a whole multiple of the timer period; the
+ *   number of periods between pulses is derived from the timestamps, so
+ *   missing pulses do not upset the loop.
+ * - The period correction is limited to 1/8 of the nominal period.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Pll sampling;
+ *
+ * // 32768 Hz ticks, 1 kHz sampling locked to PPS
+ * SoftwareTimer_PllInit(&sampling, SOFTWARETIMER_PLL_PERIOD(32768u, 1000u));
+ *
+ * void Pps_IRQHandler(void)
+ * {
+ *     SoftwareTimer_PllSync(&sampling, SoftwareTimer_Now());
+ * }
+ *
+ * // Main loop
+ * if (SoftwareTimer_PllIsExpired(&sampling)) {
+ *     Adc_Sample();
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_PLL_H
+#define SOFTWARE_TIMER_PLL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_pll Phase-locked timers
+ * @brief Periodic timers locked to an external sync pulse
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_PLL_PERIOD
+ * @brief Q16.16 period of @p ticks_per_second / @p rate ticks, rounded to nearest
+ */
+#define SOFTWARETIMER_PLL_PERIOD(ticks_per_second, rate) \
+    ((uint32_t) ((((uint64_t) (ticks_per_second) << 16) + (uint64_t) (rate) / 2u) / (uint64_t) (rate)))
+
+/**
+ * @def SOFTWARETIMER_PLL_PHASE_SHIFT
+ * @brief Proportional gain 1/2^n applied to the phase error of a sync pulse
+ */
+#ifndef SOFTWARETIMER_PLL_PHASE_SHIFT
+    #define SOFTWARETIMER_PLL_PHASE_SHIFT 1
+#endif
+
+/**
+ * @def SOFTWARETIMER_PLL_FREQUENCY_SHIFT
+ * @brief Integral gain 1/2^n applied to the per-period drift of a sync pulse
+ */
+#ifndef SOFTWARETIMER_PLL_FREQUENCY_SHIFT
+    #define SOFTWARETIMER_PLL_FREQUENCY_SHIFT 2
+#endif
+
+/**
+ * @struct SoftwareTimer_Pll
+ * @brief Phase-locked timer state structure
+ */
+typedef struct {
+    uint32_t next; /**< Tick of the next expiration */
+    uint32_t fraction; /**< Fractional part of the next expiration, 1/65536 ticks */
+    uint32_t nominal; /**< Nominal period in Q16.16 ticks */
+    int32_t correction; /**< Period correction in Q16.16 ticks */
+    int32_t error; /**< Phase error of the last sync pulse in Q16.16 ticks */
+    uint32_t lastSync; /**< Timestamp of the last sync pulse */
+    bool synced; /**< At least one sync pulse was seen */
+} SoftwareTimer_Pll;
+
+/**
+ * @brief Initializes and starts a free-running periodic timer
+ *
+ * @param[out] pll Pointer to timer structure. Must not be NULL.
+ * @param[in] period Nominal period in Q16.16 ticks, at least one tick and
+ *                   less than 32768 ticks. See @ref SOFTWARETIMER_PLL_PERIOD.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_PllInit(SoftwareTimer_Pll * pll, uint32_t period);
+
+/**
+ * @brief Feeds the timestamp of a sync pulse into the loop
+ *
+ * The first pulse aligns the phase directly; later pulses correct the phase
+ * and the period. Safe to call from the interrupt that captures the pulse
+ * if it does not preempt @ref SoftwareTimer_PllIsExpired, otherwise pass the
+ * timestamp to the polling context.
+ *
+ * @param[in,out] pll Pointer to timer. Must not be NULL.
+ * @param[in] timestamp Tick at which the pulse occurred, not in the future.
+ */
+void SoftwareTimer_PllSync(SoftwareTimer_Pll * pll, uint32_t timestamp);
+
+/**
+ * @brief Checks for and acknowledges an expiration
+ *
+ * Advances the timer by one corrected period when it returns true. If
+ * several periods were missed, successive calls return true until the timer
+ * has caught up.
+ *
+ * @param[in,out] pll Pointer to timer. Must not be NULL.
+ *
+ * @return true if an expiration was due
+ */
+bool SoftwareTimer_PllIsExpired(SoftwareTimer_Pll * pll);
+
+/**
+ * @brief Returns the ticks until the next expiration
+ *
+ * @param[in] pll Pointer to timer. Must not be NULL.
+ *
+ * @return Ticks until the next expiration, 0 if it is due
+ */
+uint32_t SoftwareTimer_PllRemaining(const SoftwareTimer_Pll * pll);
+
+/**
+ * @brief Checks whether the timer follows the reference within one tick
+ *
+ * @param[in] pll Pointer to timer. Must not be NULL.
+ *
+ * @return true if a sync pulse was seen and its phase error was at most one
+ *         tick
+ */
+bool SoftwareTimer_PllIsLocked(const SoftwareTimer_Pll * pll);
+
+/** @} */ // end of software_timer_pll group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_PLL_H
@@ -0,0 +1,208 @@
+/**
+ * @file software_timer_posix.h
+ * @brief Hosted (POSIX) helpers for waiting on I/O with a software timer deadline
+ * @author Richard Kubíček
+ *
+ * On hosted systems a timeout is usually implemented by spinning on
+ * @ref SoftwareTimer_IsExpired around non-blocking reads. The helpers in this
+ * module convert the remaining time of a @ref SoftwareTimer to a
+ * @c struct timespec and wait for file descriptors with a single @c ppoll
+ * call instead.
+ *
+ * The implementation is only compiled on POSIX systems, so the module costs
+ * nothing on bare-metal targets. The length of a clock tick is taken from
+ * @ref SOFTWARETIMER_TICK_HZ. The timespec produced by
+ * @ref SoftwareTimer_ToTimespec can also be passed to @c epoll_pwait2 or
+ * @c sigtimedwait.
+ *
+ * Event loops that sleep in the kernel (timerfd, io_uring) need the deadline
+ * as an absolute @c CLOCK_MONOTONIC time instead.
+ * @ref SoftwareTimer_ManagerNextTimespec provides it for the earliest entry of
+ * a @ref SoftwareTimer_Manager, and @ref SoftwareTimer_TimerfdArm programs a
+ * timerfd with it on Linux.
+ *
+ * io_uring event loops use software_timer_iouring.h, which owns the timeout
+ * request and falls back to the timerfd below.
+ *
+ * Event loops built on poll or epoll add a timerfd to their set; it is also
+ * the fallback when @c io_uring_queue_init fails (kernel without io_uring,
+ * or io_uring disabled by policy):
+ * @code
+ * int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+ *
+ * // After every SoftwareTimer_ManagerProcess and after arming entries
+ * SoftwareTimer_TimerfdArm(tfd, &manager);
+ *
+ * // When tfd is readable
+ * uint64_t expirations;
+ * if (read(tfd, &expirations, sizeof expirations) == sizeof expirations) {
+ *     SoftwareTimer_ManagerProcess(&manager);
+ *     SoftwareTimer_TimerfdArm(tfd, &manager);
+ * }
+ * @endcode
+ *
+ * Sleeping until a deadline wakes late by the scheduler latency, typically
+ * tens of microseconds. @ref SoftwareTimer_SleepUntil measures that latency
+ * on every sleep, keeps a smoothed estimate in a @ref SoftwareTimer_Sleeper
+ * and asks the kernel to wake it that much earlier; the remaining few
+ * microseconds are spent spinning on @c CLOCK_MONOTONIC, so the call never
+ * returns before the deadline.
+ *
+ * Usage example:
+ * @code
+ * SoftwareTimer timeout;
+ * struct pollfd pfd = {.fd = sock, .events = POLLIN};
+ *
+ * SoftwareTimer_Set(&timeout, 500);
+ * int ready = SoftwareTimer_Poll(&pfd, 1, &timeout);
+ * if (ready == 0) {
+ *     // Timed out
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_POSIX_H
+#define SOFTWARE_TIMER_POSIX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include "software_timer_manager.h"
+#include "software_timer_units.h"
+#include <poll.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @defgroup software_timer_posix POSIX helpers
+ * @brief Hosted I/O waits bounded by a software timer
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_SLEEP_MAX_MARGIN_NS
+ * @brief Upper bound of the early-wake margin in nanoseconds
+ *
+ * Bounds the time @ref SoftwareTimer_SleepUntil spins after waking, even if
+ * single wake-ups are very late. Can be overridden before including this
+ * header.
+ */
+#ifndef SOFTWARETIMER_SLEEP_MAX_MARGIN_NS
+    #define SOFTWARETIMER_SLEEP_MAX_MARGIN_NS 2000000u
+#endif
+
+/**
+ * @struct SoftwareTimer_Sleeper
+ * @brief Wake latency estimate of one sleeping thread
+ */
+typedef struct {
+    uint32_t latency; /**< Smoothed wake latency in nanoseconds, scaled by 8 */
+    uint32_t deviation; /**< Smoothed mean deviation of the latency in nanoseconds, scaled by 4 */
+    uint32_t margin; /**< Current early-wake margin in nanoseconds */
+    uint32_t lateWakes; /**< Wake-ups that came after the deadline despite the margin */
+} SoftwareTimer_Sleeper;
+
+/**
+ * @brief Converts the remaining time of a timer to a relative timespec
+ *
+ * @param[in] timer Pointer to timer. Must not be NULL.
+ * @param[out] timeout Remaining time until expiration, rounded up to whole
+ *                     nanoseconds, zero if expired. Must not be NULL.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_ToTimespec(const SoftwareTimer * timer, struct timespec * timeout);
+
+/**
+ * @brief Waits for file descriptor events until the timer expires
+ *
+ * Calls @c ppoll with the remaining time of @p timer (@c poll with the
+ * timeout rounded up to milliseconds where @c ppoll is not available). When
+ * the call is interrupted by a signal the remaining time is recomputed from
+ * the timer's start, so repeated interruptions do not extend the total wait.
+ *
+ * @param[in,out] fds Array of file descriptors, as for @c poll.
+ * @param[in] nfds Number of elements in @p fds.
+ * @param[in] timer Deadline of the wait. Must not be NULL.
+ *
+ * @return Number of ready descriptors (> 0)
+ * @retval 0 if the timer expired first
+ * @retval -1 on error other than @c EINTR, with errno set
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+int SoftwareTimer_Poll(struct pollfd * fds, nfds_t nfds, const SoftwareTimer * timer);
+
+/**
+ * @brief Returns the earliest deadline of a manager as absolute monotonic time
+ *
+ * Adds the ticks until the earliest deadline of @p manager to the current
+ * @c CLOCK_MONOTONIC time. The result is suitable for absolute timeouts such
+ * as @c IORING_TIMEOUT_ABS, @c TFD_TIMER_ABSTIME or @c clock_nanosleep with
+ * @c TIMER_ABSTIME.
+ *
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ * @param[out] deadline Absolute @c CLOCK_MONOTONIC deadline. Must not be NULL.
+ *
+ * @return true if an entry is armed and @p deadline was written
+ * @return false if no entry is armed
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+bool SoftwareTimer_ManagerNextTimespec(const SoftwareTimer_Manager * manager, struct timespec * deadline);
+
+/**
+ * @brief Arms a timerfd for the earliest deadline of a manager (Linux only)
+ *
+ * Programs @p fd (created with @c timerfd_create(CLOCK_MONOTONIC, ...)) as a
+ * one-shot absolute timer for the earliest deadline of @p manager, or
+ * disarms it when nothing is armed. Call it after every
+ * @ref SoftwareTimer_ManagerProcess and after arming entries. This is the
+ * fallback of the io_uring backend (software_timer_iouring.h).
+ *
+ * @param[in] fd Timer file descriptor.
+ * @param[in] manager Pointer to manager. Must not be NULL.
+ *
+ * @return 0 on success
+ * @retval -1 on error, with errno set
+ */
+int SoftwareTimer_TimerfdArm(int fd, const SoftwareTimer_Manager * manager);
+
+/**
+ * @brief Initializes a sleeper without latency estimate
+ *
+ * @param[out] sleeper Pointer to sleeper structure. Must not be NULL.
+ */
+void SoftwareTimer_SleeperInit(SoftwareTimer_Sleeper * sleeper);
+
+/**
+ * @brief Sleeps until a timer expires, waking early and spinning the rest
+ *
+ * Sleeps until the deadline minus the current margin, records how late the
+ * kernel woke the thread and spins on @c CLOCK_MONOTONIC until the deadline.
+ * The margin follows the smoothed latency plus four mean deviations, as TCP
+ * does for retransmission timeouts, capped at
+ * @ref SOFTWARETIMER_SLEEP_MAX_MARGIN_NS. Signals do not shorten the wait.
+ *
+ * The deadline is the remaining time of @p timer added to the current
+ * monotonic time, rounded up to whole nanoseconds. If the tick source counts
+ * @c CLOCK_MONOTONIC time, the timer is expired when the call returns.
+ *
+ * @param[in,out] sleeper Latency estimate of the calling thread. Must not be NULL.
+ * @param[in] timer Deadline of the sleep. Must not be NULL.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ *
+ * @note Use one sleeper per thread; the estimate is not synchronized.
+ */
+void SoftwareTimer_SleepUntil(SoftwareTimer_Sleeper * sleeper, const SoftwareTimer * timer);
+
+/** @} */ // end of software_timer_posix group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_POSIX_H
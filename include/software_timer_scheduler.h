@@ -0,0 +1,225 @@
+/**
+ * @file software_timer_scheduler.h
+ * @brief Cooperative task scheduler driven by the timer manager
+ * @author Richard Kubíček
+ *
+ * Replaces a superloop of @ref SoftwareTimer_IsExpired checks with
+ * protothread-style tasks. A task is a plain function that can suspend itself
+ * with @ref SOFTWARETIMER_TASK_DELAY or @ref SOFTWARETIMER_TASK_WAIT_UNTIL
+ * and continues after that point the next time it runs. Delayed tasks sleep
+ * in a @ref SoftwareTimer_Manager and are not called at all until their
+ * delay expires. @ref SoftwareTimer_SchedulerRun returns how long the CPU may
+ * sleep before the next task becomes runnable.
+ *
+ * Protothread rules
+ * - Local variables are not preserved across a suspension point. Keep state
+ *   in the structure pointed to by task->context or in static variables.
+ * - A suspension macro must not be used inside a @c switch statement of the
+ *   task body.
+ *
+ * Usage example:
+ * @code
+ * static void blink_task(SoftwareTimer_Task * task)
+ * {
+ *     SOFTWARETIMER_TASK_BEGIN(task);
+ *     while (1) {
+ *         Led_Toggle();
+ *         SOFTWARETIMER_TASK_DELAY(task, 500);
+ *     }
+ *     SOFTWARETIMER_TASK_END(task);
+ * }
+ *
+ * static SoftwareTimer_Scheduler scheduler;
+ * static SoftwareTimer_Task blink;
+ *
+ * SoftwareTimer_Init(HAL_GetTick);
+ * SoftwareTimer_SchedulerInit(&scheduler);
+ * SoftwareTimer_TaskStart(&scheduler, &blink, blink_task, NULL);
+ *
+ * while (1) {
+ *     uint32_t idle = SoftwareTimer_SchedulerRun(&scheduler);
+ *     Cpu_SleepFor(idle);
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_SCHEDULER_H
+#define SOFTWARE_TIMER_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer_manager.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_scheduler Cooperative scheduler
+ * @brief Protothread-style tasks scheduled by deadline
+ * @{
+ */
+
+typedef struct SoftwareTimer_Task SoftwareTimer_Task;
+typedef struct SoftwareTimer_Scheduler SoftwareTimer_Scheduler;
+
+/**
+ * @typedef SoftwareTimer_TaskFunction
+ * @brief Task body
+ *
+ * The body must start with @ref SOFTWARETIMER_TASK_BEGIN and end with
+ * @ref SOFTWARETIMER_TASK_END.
+ *
+ * @param[in,out] task Running task
+ */
+typedef void (*SoftwareTimer_TaskFunction)(SoftwareTimer_Task * task);
+
+/**
+ * @enum SoftwareTimer_TaskState
+ * @brief Scheduling state of a task
+ */
+typedef enum {
+    SOFTWARETIMER_TASK_READY, /**< Task runs on the next scheduler pass */
+    SOFTWARETIMER_TASK_DELAYED, /**< Task sleeps until its wake-up entry expires */
+    SOFTWARETIMER_TASK_DONE /**< Task returned through SOFTWARETIMER_TASK_END */
+} SoftwareTimer_TaskState;
+
+/**
+ * @struct SoftwareTimer_Task
+ * @brief Task state structure
+ */
+struct SoftwareTimer_Task {
+    SoftwareTimer_Entry wakeup; /**< Manager entry used to sleep during a delay */
+    SoftwareTimer_TaskFunction function; /**< Task body */
+    void * context; /**< User data for the task body */
+    SoftwareTimer_Scheduler * scheduler; /**< Scheduler running the task */
+    SoftwareTimer_Task * next; /**< Next task in the ready list */
+    uint32_t resume; /**< Continuation point (source line) inside the task body, 0 at start */
+    SoftwareTimer_TaskState state; /**< Scheduling state */
+};
+
+/**
+ * @struct SoftwareTimer_Scheduler
+ * @brief Scheduler state structure
+ */
+struct SoftwareTimer_Scheduler {
+    SoftwareTimer_Manager manager; /**< Wake-up entries of delayed tasks */
+    SoftwareTimer_Task * readyHead; /**< First runnable task */
+    SoftwareTimer_Task * readyTail; /**< Last runnable task */
+};
+
+/**
+ * @def SOFTWARETIMER_TASK_BEGIN
+ * @brief Starts a task body and jumps to the last suspension point
+ */
+#define SOFTWARETIMER_TASK_BEGIN(task) \
+    switch ((task)->resume) { \
+        case 0:
+
+/**
+ * @def SOFTWARETIMER_TASK_END
+ * @brief Ends a task body; a task reaching this point is finished
+ */
+#define SOFTWARETIMER_TASK_END(task) \
+    } \
+    (task)->resume = 0; \
+    (task)->state = SOFTWARETIMER_TASK_DONE; \
+    return
+
+/**
+ * @def SOFTWARETIMER_TASK_DELAY
+ * @brief Suspends the task for @p ticks clock ticks
+ *
+ * The task is not called again until the delay expires.
+ */
+#define SOFTWARETIMER_TASK_DELAY(task, ticks) \
+    do { \
+        SoftwareTimer_TaskDelay((task), (ticks)); \
+        (task)->resume = __LINE__; \
+        return; \
+        case __LINE__:; \
+    } while (0)
+
+/**
+ * @def SOFTWARETIMER_TASK_WAIT_UNTIL
+ * @brief Suspends the task until @p condition is true
+ *
+ * The condition is evaluated once per scheduler pass, so a waiting task keeps
+ * the scheduler from sleeping. Use @ref SOFTWARETIMER_TASK_DELAY between
+ * checks of slowly changing conditions.
+ */
+#define SOFTWARETIMER_TASK_WAIT_UNTIL(task, condition) \
+    do { \
+        (task)->resume = __LINE__; \
+        if (0) { \
+            case __LINE__:; \
+        } \
+        if (!(condition)) \
+            return; \
+    } while (0)
+
+/**
+ * @def SOFTWARETIMER_TASK_YIELD
+ * @brief Suspends the task until the next scheduler pass
+ */
+#define SOFTWARETIMER_TASK_YIELD(task) \
+    do { \
+        (task)->resume = __LINE__; \
+        return; \
+        case __LINE__:; \
+    } while (0)
+
+/**
+ * @brief Initializes a scheduler without tasks
+ *
+ * @param[out] scheduler Pointer to scheduler structure. Must not be NULL.
+ */
+void SoftwareTimer_SchedulerInit(SoftwareTimer_Scheduler * scheduler);
+
+/**
+ * @brief Starts a task
+ *
+ * The task becomes runnable and its body is called from the beginning on the
+ * next @ref SoftwareTimer_SchedulerRun.
+ *
+ * @param[in,out] scheduler Pointer to scheduler. Must not be NULL.
+ * @param[out] task Pointer to task structure. Must not be NULL and must not
+ *                  be running in any scheduler.
+ * @param[in] function Task body. Must not be NULL.
+ * @param[in] context User data available to the body as task->context.
+ */
+void SoftwareTimer_TaskStart(SoftwareTimer_Scheduler * scheduler, SoftwareTimer_Task * task, SoftwareTimer_TaskFunction function, void * context);
+
+/**
+ * @brief Puts the running task to sleep
+ *
+ * Used by @ref SOFTWARETIMER_TASK_DELAY, not intended to be called directly.
+ *
+ * @param[in,out] task Running task. Must not be NULL.
+ * @param[in] ticks Delay in clock ticks, at most INT32_MAX.
+ */
+void SoftwareTimer_TaskDelay(SoftwareTimer_Task * task, uint32_t ticks);
+
+/**
+ * @brief Runs one scheduler pass
+ *
+ * Wakes delayed tasks whose delay expired and calls every runnable task once.
+ * Delayed tasks that are still sleeping are not called.
+ *
+ * @param[in,out] scheduler Pointer to scheduler. Must not be NULL.
+ *
+ * @return Number of ticks the caller may sleep before the next pass
+ * @retval 0 if a task is runnable (ready, yielding or waiting on a condition)
+ * @retval SOFTWARETIMER_NO_DEADLINE if no task is runnable or delayed
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+uint32_t SoftwareTimer_SchedulerRun(SoftwareTimer_Scheduler * scheduler);
+
+/** @} */ // end of software_timer_scheduler group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_SCHEDULER_H
@@ -0,0 +1,164 @@
+/**
+ * @file software_timer_service.h
+ * @brief Hosted timer service thread with a bounded callback worker pool
+ * @author Richard Kubíček
+ *
+ * The service owns a @ref SoftwareTimer_Manager. One timer thread sleeps until
+ * the manager's next deadline (an absolute @c CLOCK_MONOTONIC wait) and hands
+ * every expired entry to a fixed pool of worker threads through a bounded
+ * queue. A slow callback therefore only occupies one worker instead of
+ * delaying every other timer, and callback concurrency is capped by the
+ * number of workers.
+ *
+ * When the queue is full, the configured @ref SoftwareTimer_ServicePolicy
+ * decides what happens with the next expiration.
+ *
+ * The implementation uses pthreads and is only compiled where @c __unix__ is
+ * defined (Linux, the BSDs). macOS is excluded because it lacks
+ * @c pthread_condattr_setclock, which the monotonic wait relies on.
+ *
+ * Usage example:
+ * @code
+ * static SoftwareTimer_Service service;
+ * static SoftwareTimer_Entry * queue[32];
+ * static pthread_t workers[4];
+ * static SoftwareTimer_Entry poll;
+ *
+ * SoftwareTimer_Init(millis);
+ * SoftwareTimer_ServiceStart(&service, queue, 32, workers, 4, SOFTWARETIMER_SERVICE_COALESCE);
+ * SoftwareTimer_EntryInit(&poll, poll_sensors, NULL);
+ * SoftwareTimer_ServiceArmPeriodic(&service, &poll, 100);
+ * ...
+ * SoftwareTimer_ServiceStop(&service);
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_SERVICE_H
+#define SOFTWARE_TIMER_SERVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer_manager.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_service Timer service thread
+ * @brief Dedicated timer thread with bounded callback executor
+ * @{
+ */
+
+/**
+ * @enum SoftwareTimer_ServicePolicy
+ * @brief Behaviour when an entry expires while the callback queue is full
+ */
+typedef enum {
+    SOFTWARETIMER_SERVICE_BLOCK, /**< Timer thread waits for a free queue slot; no expiration is lost */
+    SOFTWARETIMER_SERVICE_DROP, /**< Expiration is discarded and counted as dropped */
+    SOFTWARETIMER_SERVICE_COALESCE /**< Merged into a queued expiration of the same entry if there is one, otherwise the timer thread waits */
+} SoftwareTimer_ServicePolicy;
+
+/**
+ * @struct SoftwareTimer_Service
+ * @brief Service state structure
+ *
+ * All fields are protected by @c lock.
+ */
+typedef struct {
+    SoftwareTimer_Manager manager; /**< Armed entries */
+    pthread_mutex_t lock; /**< Protects the manager and the queue */
+    pthread_cond_t changed; /**< Signals the timer thread: deadline changed or stop requested */
+    pthread_cond_t notEmpty; /**< Signals workers: queue has an entry */
+    pthread_cond_t notFull; /**< Signals the timer thread: queue has a free slot */
+    SoftwareTimer_Entry ** queue; /**< Caller-provided ring buffer of expired entries */
+    uint32_t capacity; /**< Number of elements in queue */
+    uint32_t head; /**< Index of the oldest queued entry */
+    uint32_t count; /**< Number of queued entries */
+    uint32_t dropped; /**< Expirations discarded or merged because the queue was full */
+    SoftwareTimer_ServicePolicy policy; /**< Full-queue policy */
+    pthread_t timerThread; /**< Thread waiting for deadlines */
+    pthread_t * workers; /**< Caller-provided worker thread handles */
+    uint32_t workerCount; /**< Number of worker threads */
+    bool running; /**< False once stop was requested */
+} SoftwareTimer_Service;
+
+/**
+ * @brief Starts the timer thread and the worker pool
+ *
+ * @param[out] service Pointer to service structure. Must not be NULL.
+ * @param[in] queue Ring buffer storage of @p capacity elements. Must not be NULL.
+ * @param[in] capacity Maximum number of expirations waiting for a worker. Must be greater than 0.
+ * @param[out] workers Storage for @p workerCount thread handles. Must not be NULL.
+ * @param[in] workerCount Number of worker threads. Must be greater than 0.
+ * @param[in] policy Behaviour when the queue is full.
+ *
+ * @return 0 on success
+ * @return error number returned by the failing pthread call otherwise; no thread is left running
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+int SoftwareTimer_ServiceStart(SoftwareTimer_Service * service, SoftwareTimer_Entry ** queue, uint32_t capacity, pthread_t * workers, uint32_t workerCount, SoftwareTimer_ServicePolicy policy);
+
+/**
+ * @brief Stops all service threads
+ *
+ * Wakes the timer thread and the workers and joins them. Expirations still
+ * in the queue are executed before the workers exit. Must not be called from
+ * a callback.
+ *
+ * @param[in,out] service Pointer to running service. Must not be NULL.
+ */
+void SoftwareTimer_ServiceStop(SoftwareTimer_Service * service);
+
+/**
+ * @brief Arms a one-shot entry in the service
+ *
+ * Thread-safe, may be called from callbacks.
+ *
+ * @param[in,out] service Pointer to running service. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] interval Interval in clock ticks, at most INT32_MAX.
+ */
+void SoftwareTimer_ServiceArm(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry, uint32_t interval);
+
+/**
+ * @brief Arms a periodic entry in the service
+ *
+ * Thread-safe, may be called from callbacks.
+ *
+ * @param[in,out] service Pointer to running service. Must not be NULL.
+ * @param[in,out] entry Pointer to initialized entry. Must not be NULL.
+ * @param[in] period Period in clock ticks, greater than 0 and at most INT32_MAX.
+ */
+void SoftwareTimer_ServiceArmPeriodic(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry, uint32_t period);
+
+/**
+ * @brief Disarms an entry in the service
+ *
+ * Thread-safe, may be called from callbacks. An expiration that is already
+ * queued for a worker is still executed.
+ *
+ * @param[in,out] service Pointer to running service. Must not be NULL.
+ * @param[in,out] entry Pointer to entry. Must not be NULL.
+ */
+void SoftwareTimer_ServiceDisarm(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry);
+
+/**
+ * @brief Returns number of expirations dropped or coalesced
+ *
+ * @param[in,out] service Pointer to service. Must not be NULL.
+ *
+ * @return Number of expirations not executed because the queue was full
+ */
+uint32_t SoftwareTimer_ServiceDropped(SoftwareTimer_Service * service);
+
+/** @} */ // end of software_timer_service group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_SERVICE_H
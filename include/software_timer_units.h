@@ -0,0 +1,198 @@
+/**
+ * @file software_timer_units.h
+ * @brief Conversions between time units and clock ticks
+ * @author Richard Kubíček
+ *
+ * All timer functions take clock ticks. This header converts seconds,
+ * milliseconds and microseconds to ticks of a clock running at
+ * @ref SOFTWARETIMER_TICK_HZ and back, without divisions on the hot path.
+ *
+ * Design highlights
+ * - @ref SOFTWARETIMER_S, @ref SOFTWARETIMER_MS and @ref SOFTWARETIMER_US
+ *   take integer constant expressions and fold to a constant. A duration that
+ *   does not fit into 32-bit ticks is a compile error, not a silent wrap.
+ * - Time to ticks rounds up, so a timeout is never shorter than requested
+ *   (1500 us at 1 kHz is 2 ticks).
+ * - @ref SoftwareTimer_MsToTicks and @ref SoftwareTimer_UsToTicks convert
+ *   runtime values and saturate at @c UINT32_MAX.
+ * - Ticks to time (for logging and reporting) multiplies by a reciprocal
+ *   computed at compile time instead of dividing.
+ *
+ * Usage example:
+ * @code
+ * // software_timer_config.h
+ * #define SOFTWARETIMER_TICK_HZ 32768u
+ *
+ * SoftwareTimer_Set(&timeout, SOFTWARETIMER_MS(250)); // 8192 ticks
+ * printf("%u ms left\n", (unsigned) SoftwareTimer_TicksToMs(SoftwareTimer_Remaining(&timeout)));
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_UNITS_H
+#define SOFTWARE_TIMER_UNITS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_units Time units
+ * @brief Tick rate and time unit conversions
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_TICK_HZ
+ * @brief Number of clock ticks per second
+ *
+ * Rate of the clock source passed to @ref SoftwareTimer_Init. Define it in
+ * your configuration file (see software_timer_config_template.h) when the
+ * clock source does not count milliseconds.
+ */
+#ifndef SOFTWARETIMER_TICK_HZ
+    #define SOFTWARETIMER_TICK_HZ 1000u
+#endif
+
+#if SOFTWARETIMER_TICK_HZ == 0
+    #error "SOFTWARETIMER_TICK_HZ must be greater than 0"
+#endif
+
+/**
+ * @brief Converts @p value units of @p per_second to ticks as uint64_t, rounded up
+ */
+#define SOFTWARETIMER_TICKS_(value, per_second) \
+    (((uint64_t) (value) * SOFTWARETIMER_TICK_HZ + ((per_second) - 1u)) / (per_second))
+
+/**
+ * @brief Evaluates to 0; fails to compile if @p ticks does not fit into 32 bits
+ *
+ * A bit-field of negative width is a constraint violation, and a bit-field
+ * width must be an integer constant expression, so a non-constant argument
+ * is rejected as well. C++ does not allow type definitions in @c sizeof; there
+ * the check is omitted.
+ */
+#ifdef __cplusplus
+    #define SOFTWARETIMER_CHECK_TICKS_(ticks) 0u
+#else
+    #define SOFTWARETIMER_CHECK_TICKS_(ticks) \
+        (0u * sizeof(struct { int tick_overflow : ((ticks) <= UINT32_MAX) ? 1 : -1; }))
+#endif
+
+/**
+ * @brief Converts a constant number of seconds to ticks
+ *
+ * @param seconds Integer constant expression.
+ */
+#define SOFTWARETIMER_S(seconds) \
+    ((uint32_t) (SOFTWARETIMER_TICKS_(seconds, 1u) + SOFTWARETIMER_CHECK_TICKS_(SOFTWARETIMER_TICKS_(seconds, 1u))))
+
+/**
+ * @brief Converts a constant number of milliseconds to ticks, rounded up
+ *
+ * @param milliseconds Integer constant expression.
+ */
+#define SOFTWARETIMER_MS(milliseconds) \
+    ((uint32_t) (SOFTWARETIMER_TICKS_(milliseconds, 1000u) + SOFTWARETIMER_CHECK_TICKS_(SOFTWARETIMER_TICKS_(milliseconds, 1000u))))
+
+/**
+ * @brief Converts a constant number of microseconds to ticks, rounded up
+ *
+ * @param microseconds Integer constant expression.
+ */
+#define SOFTWARETIMER_US(microseconds) \
+    ((uint32_t) (SOFTWARETIMER_TICKS_(microseconds, 1000000u) + SOFTWARETIMER_CHECK_TICKS_(SOFTWARETIMER_TICKS_(microseconds, 1000000u))))
+
+/**
+ * @brief 32.32 fixed-point milliseconds per tick, rounded up
+ */
+#define SOFTWARETIMER_MS_PER_TICK_ ((((uint64_t) 1000u << 32) + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ)
+
+/**
+ * @brief 32.32 fixed-point microseconds per tick, rounded up
+ */
+#define SOFTWARETIMER_US_PER_TICK_ ((((uint64_t) 1000000u << 32) + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ)
+
+/**
+ * @brief Saturates a 64-bit tick count to 32 bits
+ */
+static inline uint32_t softwaretimer_saturate_(uint64_t ticks)
+{
+    return ticks > UINT32_MAX ? UINT32_MAX : (uint32_t) ticks;
+}
+
+/**
+ * @brief Multiplies @p ticks by a 32.32 fixed-point factor
+ *
+ * The 96-bit product is formed from two 64-bit products, so factors of
+ * 2^32 and more (coarse ticks, fine units) do not overflow.
+ */
+static inline uint64_t softwaretimer_scale_(uint32_t ticks, uint64_t factor)
+{
+    return (uint64_t) ticks * (factor >> 32) + (((uint64_t) ticks * (uint32_t) factor) >> 32);
+}
+
+/**
+ * @brief Converts milliseconds to ticks at runtime, rounded up
+ *
+ * @param[in] milliseconds Duration in milliseconds.
+ *
+ * @return Ticks, saturated at @c UINT32_MAX
+ */
+static inline uint32_t SoftwareTimer_MsToTicks(uint32_t milliseconds)
+{
+    return softwaretimer_saturate_(SOFTWARETIMER_TICKS_(milliseconds, 1000u));
+}
+
+/**
+ * @brief Converts microseconds to ticks at runtime, rounded up
+ *
+ * @param[in] microseconds Duration in microseconds.
+ *
+ * @return Ticks, saturated at @c UINT32_MAX
+ */
+static inline uint32_t SoftwareTimer_UsToTicks(uint32_t microseconds)
+{
+    return softwaretimer_saturate_(SOFTWARETIMER_TICKS_(microseconds, 1000000u));
+}
+
+/**
+ * @brief Converts ticks to milliseconds for reporting
+ *
+ * @param[in] ticks Duration in ticks.
+ *
+ * @return Milliseconds, rounded down
+ *
+ * @note Uses multiplication by a reciprocal rounded up to 32 fractional
+ *       bits. The result is exact when the tick rate divides 1000 or is a
+ *       power of two; otherwise it may be one millisecond high for very
+ *       large tick counts.
+ */
+static inline uint64_t SoftwareTimer_TicksToMs(uint32_t ticks)
+{
+    return softwaretimer_scale_(ticks, SOFTWARETIMER_MS_PER_TICK_);
+}
+
+/**
+ * @brief Converts ticks to microseconds for reporting
+ *
+ * @param[in] ticks Duration in ticks.
+ *
+ * @return Microseconds, rounded down
+ *
+ * @note Same precision as @ref SoftwareTimer_TicksToMs.
+ */
+static inline uint64_t SoftwareTimer_TicksToUs(uint32_t ticks)
+{
+    return softwaretimer_scale_(ticks, SOFTWARETIMER_US_PER_TICK_);
+}
+
+/** @} */ // end of software_timer_units group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_UNITS_H
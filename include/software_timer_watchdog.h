@@ -0,0 +1,121 @@
+/**
+ * @file software_timer_watchdog.h
+ * @brief Software watchdog multiplexer over a single hardware watchdog
+ * @author Richard Kubíček
+ *
+ * Every supervised task has a liveness timeout and must check in before it
+ * passes. The hardware watchdog is kicked only while all tasks are alive, so
+ * one stuck task resets the system although other tasks keep running.
+ *
+ * Design highlights
+ * - A task's slot is a @ref SoftwareTimer. Checking in stores the current
+ *   time to its start, one 32-bit store that is safe from tasks and ISRs.
+ * - @ref SoftwareTimer_WatchdogCheck keeps the earliest deadline of all
+ *   tasks. Check-ins only move deadlines later, so while the cached deadline
+ *   has not passed all tasks are alive and the check is one comparison. Only
+ *   when it passes are the slots rescanned.
+ * - A failed check reports the index of the most overdue task.
+ * - Timeouts must not exceed INT32_MAX ticks, and the check has to run at
+ *   least once per INT32_MAX ticks.
+ *
+ * Usage example:
+ * @code
+ * enum { TASK_COMM, TASK_CONTROL, TASK_LOGGER, TASK_COUNT };
+ *
+ * static const uint32_t timeouts[TASK_COUNT] = {500, 50, 2000};
+ * static SoftwareTimer slots[TASK_COUNT];
+ * static SoftwareTimer_Watchdog watchdog;
+ *
+ * SoftwareTimer_WatchdogInit(&watchdog, slots, timeouts, TASK_COUNT);
+ *
+ * // In every task loop
+ * SoftwareTimer_WatchdogCheckIn(&watchdog, TASK_CONTROL);
+ *
+ * // Periodically, for example every 10 ms
+ * uint32_t starved = SoftwareTimer_WatchdogCheck(&watchdog);
+ * if (starved == SOFTWARETIMER_WATCHDOG_ALIVE) {
+ *     Iwdg_Kick();
+ * } else {
+ *     Log_Fatal("task %u starved", (unsigned) starved);
+ * }
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_WATCHDOG_H
+#define SOFTWARE_TIMER_WATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "software_timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_watchdog Watchdog multiplexer
+ * @brief Combined liveness check of many tasks
+ * @{
+ */
+
+/**
+ * @def SOFTWARETIMER_WATCHDOG_ALIVE
+ * @brief Value returned by @ref SoftwareTimer_WatchdogCheck when all tasks are alive
+ */
+#define SOFTWARETIMER_WATCHDOG_ALIVE UINT32_MAX
+
+/**
+ * @struct SoftwareTimer_Watchdog
+ * @brief Watchdog multiplexer state structure
+ */
+typedef struct {
+    SoftwareTimer * slots; /**< Caller-provided slot per task; start is the last check-in */
+    uint32_t count; /**< Number of supervised tasks */
+    uint32_t earliest; /**< Cached absolute deadline; no task can expire before it */
+} SoftwareTimer_Watchdog;
+
+/**
+ * @brief Initializes the multiplexer with all tasks checked in
+ *
+ * @param[out] watchdog Pointer to multiplexer structure. Must not be NULL.
+ * @param[out] slots Storage for @p count slots. Must not be NULL.
+ * @param[in] timeouts Liveness timeout of each task in clock ticks, each
+ *                     greater than 0 and at most INT32_MAX. Copied into the slots.
+ * @param[in] count Number of supervised tasks, greater than 0.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_WatchdogInit(SoftwareTimer_Watchdog * watchdog, SoftwareTimer * slots, const uint32_t * timeouts, uint32_t count);
+
+/**
+ * @brief Reports that a task is alive
+ *
+ * @param[in,out] watchdog Pointer to multiplexer. Must not be NULL.
+ * @param[in] task Task index, less than the task count.
+ *
+ * @note Reads the clock and performs a single store, no read-modify-write
+ *       of shared state. Callable from any task or ISR.
+ */
+void SoftwareTimer_WatchdogCheckIn(SoftwareTimer_Watchdog * watchdog, uint32_t task);
+
+/**
+ * @brief Decides whether the hardware watchdog may be kicked
+ *
+ * @param[in,out] watchdog Pointer to multiplexer. Must not be NULL.
+ *
+ * @return Index of the most overdue task
+ * @retval SOFTWARETIMER_WATCHDOG_ALIVE if every task checked in within its timeout
+ *
+ * @note Reads the clock once. O(1) while the cached earliest deadline has
+ *       not passed, otherwise O(number of tasks).
+ * @note Call from one context only.
+ */
+uint32_t SoftwareTimer_WatchdogCheck(SoftwareTimer_Watchdog * watchdog);
+
+/** @} */ // end of software_timer_watchdog group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_WATCHDOG_H
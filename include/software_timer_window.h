@@ -0,0 +1,115 @@
+/**
+ * @file software_timer_window.h
+ * @brief Sliding-window event counter driven by the software timer clock
+ * @author Richard Kubíček
+ *
+ * The window counter answers questions such as "how many events happened in
+ * the last second" without ring buffers of timestamps and without timers per
+ * bucket. The window is split into a fixed number of buckets. Buckets are
+ * advanced lazily from the elapsed clock ticks whenever the counter is
+ * touched, so an idle counter costs nothing.
+ *
+ * Design highlights
+ * - Uses the clock source registered with @ref SoftwareTimer_Init.
+ * - Bucket storage is provided by the caller, no dynamic allocation.
+ * - O(1) increment and O(1) amortized sum query. The running sum is kept
+ *   up to date, a query never iterates over the buckets.
+ * - A long idle period clears the window in at most one pass over the buckets.
+ *
+ * Usage example:
+ * @code
+ * static uint32_t buckets[10];
+ * static SoftwareTimer_Window rxRate;
+ *
+ * SoftwareTimer_WindowInit(&rxRate, buckets, 10, 100); // 1 s window, 100 ms buckets
+ *
+ * // For each received frame
+ * SoftwareTimer_WindowAdd(&rxRate, 1);
+ *
+ * // Frames received in the last second
+ * uint32_t frames = SoftwareTimer_WindowSum(&rxRate);
+ * @endcode
+ */
+
+#ifndef SOFTWARE_TIMER_WINDOW_H
+#define SOFTWARE_TIMER_WINDOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @defgroup software_timer_window Sliding-window counter
+ * @brief Bucketed event counter over a sliding time window
+ * @{
+ */
+
+/**
+ * @struct SoftwareTimer_Window
+ * @brief Sliding-window counter state structure
+ *
+ * The window covers @c bucketCount buckets of @c bucketWidth ticks each. The
+ * bucket at index @c head is the current one and started at @c headStart.
+ */
+typedef struct {
+    uint32_t * buckets; /**< Caller-provided bucket storage with bucketCount elements */
+    uint32_t bucketCount; /**< Number of buckets in the window */
+    uint32_t bucketWidth; /**< Width of one bucket in clock ticks */
+    uint32_t head; /**< Index of the current bucket */
+    uint32_t headStart; /**< Timestamp at which the current bucket started */
+    uint32_t sum; /**< Running sum over all buckets */
+} SoftwareTimer_Window;
+
+/**
+ * @brief Initializes a sliding-window counter
+ *
+ * Clears the bucket storage and starts the current bucket at the current
+ * clock time. The window length is @p bucketCount * @p bucketWidth ticks.
+ *
+ * @param[out] window Pointer to counter structure. Must not be NULL.
+ * @param[in] buckets Bucket storage of @p bucketCount elements. Must not be NULL.
+ * @param[in] bucketCount Number of buckets. Must be greater than 0.
+ * @param[in] bucketWidth Width of one bucket in clock ticks. Must be greater than 0.
+ *
+ * @pre @ref SoftwareTimer_Init must have been called
+ */
+void SoftwareTimer_WindowInit(SoftwareTimer_Window * window, uint32_t * buckets, uint32_t bucketCount, uint32_t bucketWidth);
+
+/**
+ * @brief Adds events to the current bucket
+ *
+ * Advances the window to the current time and adds @p amount to the current
+ * bucket.
+ *
+ * @param[in,out] window Pointer to counter structure. Must not be NULL.
+ * @param[in] amount Number of events to add.
+ *
+ * @note Reads the clock once. When the current bucket is still open the call
+ *       is a comparison and two additions.
+ */
+void SoftwareTimer_WindowAdd(SoftwareTimer_Window * window, uint32_t amount);
+
+/**
+ * @brief Returns number of events in the window
+ *
+ * Advances the window to the current time and returns the running sum. The
+ * result covers the current (partially filled) bucket and the
+ * @c bucketCount - 1 preceding buckets.
+ *
+ * @param[in,out] window Pointer to counter structure. Must not be NULL.
+ *
+ * @return Sum of events in the window
+ *
+ * @note Reads the clock once.
+ */
+uint32_t SoftwareTimer_WindowSum(SoftwareTimer_Window * window);
+
+/** @} */ // end of software_timer_window group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTWARE_TIMER_WINDOW_H
@@ -16,30 +16,11 @@
  */
 
 #include "software_timer.h"
+#include "software_timer_private.h"
 #include <stddef.h>
-
-/**
- * @def SOFTWARETIMER_ASSERT
- * @brief Configurable assertion macro for parameter validation
- *
- * Users can define their own assertion handler by defining SOFTWARETIMER_ASSERT
- * before including this file. If not defined, the default behavior is:
- * - In debug builds (NDEBUG not defined): use standard assert()
- * - In release builds (NDEBUG defined): compile to empty statement
- *
- * Example of custom assertion:
- * @code
- * #define SOFTWARETIMER_ASSERT(expr) if(!(expr)) my_error_handler()
- * #include "software_timer.c"
- * @endcode
- */
-#ifndef SOFTWARETIMER_ASSERT
-    #ifdef NDEBUG
-        #define SOFTWARETIMER_ASSERT(expr) ((void) 0)
-    #else
-        #include <assert.h>
-        #define SOFTWARETIMER_ASSERT(expr) assert(expr)
-    #endif
+#if defined(SOFTWARETIMER_STATS) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    #define CLOCK_READS_C11
 #endif
 
 /**
@@ -62,6 +43,41 @@
  */
 static SoftwareTimer_ClockTime clockTime;
 
+#ifdef SOFTWARETIMER_STATS
+/**
+ * @var clockReads
+ * @brief Number of clock source reads, for @ref SoftwareTimer_ClockReads
+ *
+ * The clock is read from every context that uses the library, so the
+ * counter is a relaxed atomic: C11 atomics, else the GCC builtins, else a
+ * plain integer on compilers with neither.
+ */
+    #ifdef CLOCK_READS_C11
+static _Atomic uint32_t clockReads;
+        #define CLOCK_READS_INCREMENT() atomic_fetch_add_explicit(&clockReads, 1u, memory_order_relaxed)
+        #define CLOCK_READS_LOAD() atomic_load_explicit(&clockReads, memory_order_relaxed)
+    #elif defined(__GNUC__)
+static uint32_t clockReads;
+        #define CLOCK_READS_INCREMENT() __atomic_fetch_add(&clockReads, 1u, __ATOMIC_RELAXED)
+        #define CLOCK_READS_LOAD() __atomic_load_n(&clockReads, __ATOMIC_RELAXED)
+    #else
+static volatile uint32_t clockReads;
+        #define CLOCK_READS_INCREMENT() (clockReads++)
+        #define CLOCK_READS_LOAD() (clockReads)
+    #endif
+#endif
+
+/**
+ * Reads the clock source. With SOFTWARETIMER_STATS every read is counted.
+ */
+static uint32_t clock_read(void)
+{
+#ifdef SOFTWARETIMER_STATS
+    (void) CLOCK_READS_INCREMENT();
+#endif
+    return clockTime();
+}
+
 /**
  * Stores the clock function pointer for later use by timer operations.
  * This function must be called before any timer functionality is used.
@@ -76,6 +92,16 @@ void SoftwareTimer_Init(SoftwareTimer_ClockTime clock)
     clockTime = clock;
 }
 
+/**
+ * Reads the shared clock source. Used by the library modules so that all of
+ * them observe the same time base as the core timers.
+ */
+uint32_t SoftwareTimer_Now(void)
+{
+    SOFTWARETIMER_ASSERT(clockTime != NULL);
+    return clock_read();
+}
+
 /**
  * Captures the current time as start reference and configures
  * the timer to expire after the specified interval. The timer
@@ -91,7 +117,7 @@ void SoftwareTimer_Set(SoftwareTimer * timer, uint32_t interval)
 {
     SOFTWARETIMER_ASSERT(timer != NULL);
     SOFTWARETIMER_ASSERT(clockTime != NULL);
-    timer->start = clockTime();
+    timer->start = clock_read();
     timer->interval = interval;
     timer->evaluated = false;
 }
@@ -108,7 +134,7 @@ bool SoftwareTimer_IsExpired(const SoftwareTimer * timer)
 {
     SOFTWARETIMER_ASSERT(timer != NULL);
     SOFTWARETIMER_ASSERT(clockTime != NULL);
-    if (clockTime() - timer->start >= timer->interval) {
+    if (clock_read() - timer->start >= timer->interval) {
         return true;
     }
     return false;
@@ -129,7 +155,7 @@ uint32_t SoftwareTimer_Remaining(const SoftwareTimer * timer)
 {
     SOFTWARETIMER_ASSERT(timer != NULL);
     SOFTWARETIMER_ASSERT(clockTime != NULL);
-    uint32_t elapsed = clockTime() - timer->start;
+    uint32_t elapsed = clock_read() - timer->start;
 
     if (elapsed >= timer->interval) {
         return 0; // Timer has expired
@@ -158,11 +184,111 @@ bool SoftwareTimer_IsExpiredEvaluatedOnce(SoftwareTimer * timer)
     if (timer->evaluated)
         return false;
 
-    if (clockTime() - timer->start >= timer->interval) {
+    if (clock_read() - timer->start >= timer->interval) {
         timer->evaluated = true;
         return true;
     }
     return false;
 }
 
+/**
+ * Starts the underlying timer and stores the repeat counter.
+ *
+ * Implementation details:
+ * - Delegates to SoftwareTimer_Set() for the single clock read
+ * - A zero count marks the timer as evaluated so it never fires
+ */
+void SoftwareTimer_SetRepeating(SoftwareTimer_Repeating * timer, uint32_t interval, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    SoftwareTimer_Set(&timer->timer, interval);
+    timer->count = count;
+    timer->timer.evaluated = (count == 0);
+}
+
+/**
+ * Reports one expiration per elapsed interval until the counter is exhausted.
+ *
+ * Implementation:
+ * - Exhausted timers return false without reading the clock
+ * - On expiration the start is advanced by the interval (drift-free rearm)
+ * - The last expiration sets the evaluated flag of the underlying timer
+ */
+bool SoftwareTimer_IsExpiredRepeating(SoftwareTimer_Repeating * timer)
+{
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    SOFTWARETIMER_ASSERT(clockTime != NULL);
+    if (timer->count == 0)
+        return false;
+
+    if (clock_read() - timer->timer.start >= timer->timer.interval) {
+        timer->timer.start += timer->timer.interval;
+        timer->count--;
+        timer->timer.evaluated = (timer->count == 0);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the stored repeat counter.
+ */
+uint32_t SoftwareTimer_RepeatsLeft(const SoftwareTimer_Repeating * timer)
+{
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    return timer->count;
+}
+
+/**
+ * Stores the remaining time of every timer.
+ *
+ * Implementation:
+ * - The clock is read once and shared by all timers of the set
+ * - Remaining time uses the same unsigned arithmetic as SoftwareTimer_Remaining()
+ */
+void SoftwareTimer_Suspend(const SoftwareTimer * timers, SoftwareTimer_Retained * retained, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(timers != NULL);
+    SOFTWARETIMER_ASSERT(retained != NULL);
+    SOFTWARETIMER_ASSERT(clockTime != NULL);
+    uint32_t now = clock_read();
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t elapsed = now - timers[i].start;
+        retained[i].remaining = elapsed >= timers[i].interval ? 0 : timers[i].interval - elapsed;
+        retained[i].evaluated = timers[i].evaluated;
+    }
+}
+
+/**
+ * Restarts every timer now with its remaining time minus the sleep time.
+ *
+ * Implementation:
+ * - The clock is read once and used as the new start of all timers
+ * - Remaining time is clamped at 0 for timers that expired during sleep
+ */
+void SoftwareTimer_Resume(SoftwareTimer * timers, const SoftwareTimer_Retained * retained, uint32_t count, uint32_t slept)
+{
+    SOFTWARETIMER_ASSERT(timers != NULL);
+    SOFTWARETIMER_ASSERT(retained != NULL);
+    SOFTWARETIMER_ASSERT(clockTime != NULL);
+    uint32_t now = clock_read();
+
+    for (uint32_t i = 0; i < count; i++) {
+        timers[i].start = now;
+        timers[i].interval = retained[i].remaining > slept ? retained[i].remaining - slept : 0;
+        timers[i].evaluated = retained[i].evaluated;
+    }
+}
+
+#ifdef SOFTWARETIMER_STATS
+/**
+ * Returns the counter maintained by clock_read().
+ */
+uint32_t SoftwareTimer_ClockReads(void)
+{
+    return CLOCK_READS_LOAD();
+}
+#endif
+
 /** @} */
\ No newline at end of file
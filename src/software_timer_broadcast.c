@@ -0,0 +1,120 @@
+/**
+ * @file software_timer_broadcast.c
+ * @brief Broadcast timers implementation
+ * @author Richard Kubíček
+ *
+ * Subscribers form a doubly linked list headed by the broadcast. New
+ * subscribers are added at the head, behind which the notification cursor
+ * always lies, so they are not reached by a notification in progress.
+ *
+ * @see software_timer_broadcast.h for API documentation
+ */
+
+#include "software_timer_broadcast.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_broadcast
+ * @{
+ */
+
+/**
+ * Notifies every subscriber; manager callback of the broadcast entry.
+ *
+ * Implementation:
+ * - The cursor is advanced before each callback, and unsubscribing the
+ *   subscriber under the cursor moves it on, so callbacks may unsubscribe
+ *   any subscriber
+ */
+static void broadcast_expired(SoftwareTimer_Entry * entry)
+{
+    SoftwareTimer_Broadcast * broadcast = (SoftwareTimer_Broadcast *) entry;
+    SoftwareTimer_Subscriber * subscriber;
+
+    broadcast->cursor = broadcast->head;
+    while ((subscriber = broadcast->cursor) != NULL) {
+        broadcast->cursor = subscriber->next;
+        subscriber->callback(subscriber);
+    }
+}
+
+/**
+ * Prepares the periodic entry; it is armed by the first subscriber.
+ */
+void SoftwareTimer_BroadcastInit(SoftwareTimer_Broadcast * broadcast, SoftwareTimer_Manager * manager, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(broadcast != NULL);
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(period > 0 && period <= INT32_MAX);
+
+    SoftwareTimer_EntryInit(&broadcast->entry, broadcast_expired, NULL);
+    broadcast->manager = manager;
+    broadcast->period = period;
+    broadcast->head = NULL;
+    broadcast->cursor = NULL;
+}
+
+/**
+ * Stores the callback and marks the subscriber as not subscribed.
+ */
+void SoftwareTimer_SubscriberInit(SoftwareTimer_Subscriber * subscriber, SoftwareTimer_SubscriberCallback callback, void * context)
+{
+    SOFTWARETIMER_ASSERT(subscriber != NULL);
+    SOFTWARETIMER_ASSERT(callback != NULL);
+    subscriber->callback = callback;
+    subscriber->context = context;
+    subscriber->broadcast = NULL;
+    subscriber->next = NULL;
+    subscriber->prev = NULL;
+}
+
+/**
+ * Links the subscriber at the head and arms the entry if the list was empty.
+ */
+void SoftwareTimer_BroadcastSubscribe(SoftwareTimer_Broadcast * broadcast, SoftwareTimer_Subscriber * subscriber)
+{
+    SOFTWARETIMER_ASSERT(broadcast != NULL);
+    SOFTWARETIMER_ASSERT(subscriber != NULL);
+    SOFTWARETIMER_ASSERT(subscriber->broadcast == NULL);
+
+    subscriber->broadcast = broadcast;
+    subscriber->prev = NULL;
+    subscriber->next = broadcast->head;
+    if (broadcast->head != NULL)
+        broadcast->head->prev = subscriber;
+    broadcast->head = subscriber;
+
+    if (!SoftwareTimer_EntryIsActive(&broadcast->entry))
+        SoftwareTimer_ManagerStartPeriodic(broadcast->manager, &broadcast->entry, broadcast->period);
+}
+
+/**
+ * Unlinks the subscriber, moving the notification cursor past it, and stops
+ * the entry when the list becomes empty.
+ */
+void SoftwareTimer_BroadcastUnsubscribe(SoftwareTimer_Subscriber * subscriber)
+{
+    SOFTWARETIMER_ASSERT(subscriber != NULL);
+    SoftwareTimer_Broadcast * broadcast = subscriber->broadcast;
+
+    if (broadcast == NULL)
+        return;
+
+    if (broadcast->cursor == subscriber)
+        broadcast->cursor = subscriber->next;
+    if (subscriber->prev != NULL)
+        subscriber->prev->next = subscriber->next;
+    else
+        broadcast->head = subscriber->next;
+    if (subscriber->next != NULL)
+        subscriber->next->prev = subscriber->prev;
+    subscriber->broadcast = NULL;
+    subscriber->next = NULL;
+    subscriber->prev = NULL;
+
+    if (broadcast->head == NULL)
+        SoftwareTimer_ManagerStop(broadcast->manager, &broadcast->entry);
+}
+
+/** @} */
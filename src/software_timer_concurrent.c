@@ -0,0 +1,369 @@
+/**
+ * @file software_timer_concurrent.c
+ * @brief Timer manager with arming from any thread implementation
+ * @author Richard Kubíček
+ *
+ * State word of an entry:
+ * - bit 0 (ON_STACK): the entry is on the request stack or detached by the
+ *   processing thread and not yet applied; it must not be pushed again
+ * - bit 1 (WRITING): a thread is writing the request fields
+ * - bits 2-3: status of the latest request (IDLE, REQUESTED, ARMED, CANCELLED)
+ * - bit 4 (FIRING): the processing thread is running the callback
+ * - bits 5-31: sequence number, advanced by every request so that the
+ *   processing thread detects a request that changed while it was read
+ *
+ * Only the processing thread touches the embedded manager entry; other
+ * threads communicate through the state word and the request fields. The
+ * processing thread holds no reference to an entry once ON_STACK and FIRING
+ * are both clear and the entry is not armed, which is what a synchronous
+ * cancel waits for. Entry memory is owned by the caller, so no deferred
+ * reclamation is needed beyond that wait.
+ *
+ * Compiled only with C11 atomics.
+ *
+ * @see software_timer_concurrent.h for API documentation
+ */
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+    #include "software_timer_concurrent.h"
+    #include "software_timer_private.h"
+    #include <stddef.h>
+
+/**
+ * @addtogroup software_timer_concurrent
+ * @{
+ */
+
+    #define STATE_ON_STACK 0x1u
+    #define STATE_WRITING 0x2u
+    #define STATE_STATUS_MASK 0xCu
+    #define STATE_IDLE 0x0u
+    #define STATE_REQUESTED 0x4u
+    #define STATE_ARMED 0x8u
+    #define STATE_CANCELLED 0xCu
+    #define STATE_FIRING 0x10u
+    #define STATE_SEQUENCE 0x20u
+
+/**
+ * Pushes an entry onto the request stack.
+ *
+ * @return true if the stack was empty
+ */
+static bool concurrent_push(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry)
+{
+    SoftwareTimer_ConcurrentEntry * head = atomic_load_explicit(&concurrent->pending, memory_order_relaxed);
+
+    do {
+        entry->pendingNext = head;
+    } while (!atomic_compare_exchange_weak_explicit(&concurrent->pending, &head, entry, memory_order_release, memory_order_relaxed));
+    return head == NULL;
+}
+
+/**
+ * Claims the request fields of an entry by setting WRITING.
+ */
+static void entry_claim(SoftwareTimer_ConcurrentEntry * entry)
+{
+    uint32_t state = atomic_load_explicit(&entry->state, memory_order_relaxed);
+
+    for (;;) {
+        if ((state & STATE_WRITING) != 0) {
+            state = atomic_load_explicit(&entry->state, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&entry->state, &state, state | STATE_WRITING, memory_order_acquire, memory_order_relaxed))
+            return;
+    }
+}
+
+/**
+ * Releases WRITING without publishing a request.
+ */
+static void entry_release(SoftwareTimer_ConcurrentEntry * entry)
+{
+    uint32_t state = atomic_load_explicit(&entry->state, memory_order_relaxed);
+
+    while (!atomic_compare_exchange_weak_explicit(&entry->state, &state, state & ~STATE_WRITING, memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Publishes a request: advances the sequence, sets @p status, releases
+ * WRITING and pushes the entry unless it already is on the stack.
+ *
+ * Implementation:
+ * - While WRITING is set only the processing thread changes the word, by
+ *   clearing FIRING; the loop retries with the new value
+ * - @p previous receives the word as it was replaced
+ */
+static bool entry_publish(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t status, uint32_t * previous)
+{
+    uint32_t state = atomic_load_explicit(&entry->state, memory_order_relaxed);
+    uint32_t next;
+
+    do {
+        next = ((state & ~(STATE_WRITING | STATE_STATUS_MASK)) + STATE_SEQUENCE) | status | STATE_ON_STACK;
+    } while (!atomic_compare_exchange_weak_explicit(&entry->state, &state, next, memory_order_release, memory_order_relaxed));
+
+    *previous = state;
+    if ((state & STATE_ON_STACK) != 0)
+        return false;
+    return concurrent_push(concurrent, entry);
+}
+
+/**
+ * Marks an expired entry as firing if its latest request is still the
+ * applied arm request. A one-shot entry becomes IDLE at the same time.
+ *
+ * @return false if the entry must be dropped instead of fired
+ */
+static bool entry_begin_fire(SoftwareTimer_ConcurrentEntry * entry)
+{
+    uint32_t status = entry->entry.period != 0 ? STATE_ARMED : STATE_IDLE;
+    uint32_t state = atomic_load_explicit(&entry->state, memory_order_acquire);
+
+    do {
+        if ((state & (STATE_WRITING | STATE_STATUS_MASK)) != STATE_ARMED)
+            return false;
+    } while (!atomic_compare_exchange_weak_explicit(&entry->state, &state, (state & ~STATE_STATUS_MASK) | status | STATE_FIRING, memory_order_acquire,
+                                                    memory_order_acquire));
+    return true;
+}
+
+/**
+ * Stores an arm request and publishes it.
+ */
+static bool concurrent_arm(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t interval, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    SOFTWARETIMER_ASSERT(interval <= INT32_MAX);
+
+    uint32_t previous;
+
+    entry_claim(entry);
+    atomic_store_explicit(&entry->requestStart, SoftwareTimer_Now(), memory_order_relaxed);
+    atomic_store_explicit(&entry->requestInterval, interval, memory_order_relaxed);
+    atomic_store_explicit(&entry->requestPeriod, period, memory_order_relaxed);
+    return entry_publish(concurrent, entry, STATE_REQUESTED, &previous);
+}
+
+/**
+ * Applies the latest request of a detached entry to the private manager.
+ *
+ * Implementation:
+ * - The request fields are read between two observations of the state
+ *   word; the closing compare-and-swap fails if a request was published
+ *   in between, and the read is repeated
+ * - An entry whose request is being written is pushed back. Its writer
+ *   sees ON_STACK and neither pushes it again nor wakes the processing
+ *   thread, so the caller must process again without sleeping
+ * - A cancelled entry is unlinked before ON_STACK is cleared, so that a
+ *   synchronous cancel never returns while the entry is still linked
+ *
+ * @return false if the entry was pushed back
+ */
+static bool concurrent_apply(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry)
+{
+    uint32_t state = atomic_load_explicit(&entry->state, memory_order_acquire);
+
+    for (;;) {
+        if ((state & STATE_WRITING) != 0) {
+            concurrent_push(concurrent, entry);
+            return false;
+        }
+
+        uint32_t status = state & STATE_STATUS_MASK;
+        uint32_t start = atomic_load_explicit(&entry->requestStart, memory_order_relaxed);
+        uint32_t interval = atomic_load_explicit(&entry->requestInterval, memory_order_relaxed);
+        uint32_t period = atomic_load_explicit(&entry->requestPeriod, memory_order_relaxed);
+        uint32_t next = state & ~(STATE_ON_STACK | STATE_STATUS_MASK);
+        next |= status == STATE_REQUESTED ? STATE_ARMED : status;
+
+        if (status != STATE_REQUESTED)
+            SoftwareTimer_ManagerStop(&concurrent->manager, &entry->entry);
+        if (!atomic_compare_exchange_weak_explicit(&entry->state, &state, next, memory_order_acq_rel, memory_order_acquire))
+            continue;
+
+        if (status == STATE_REQUESTED)
+            SoftwareTimer_ManagerStartFrom(&concurrent->manager, &entry->entry, start, interval, period);
+        return true;
+    }
+}
+
+/**
+ * Detaches the request stack and applies every entry on it.
+ *
+ * @return false if an entry was pushed back
+ */
+static bool concurrent_drain(SoftwareTimer_Concurrent * concurrent)
+{
+    SoftwareTimer_ConcurrentEntry * entry = atomic_exchange_explicit(&concurrent->pending, NULL, memory_order_acquire);
+    bool applied = true;
+
+    while (entry != NULL) {
+        SoftwareTimer_ConcurrentEntry * next = entry->pendingNext;
+        applied &= concurrent_apply(concurrent, entry);
+        entry = next;
+    }
+    return applied;
+}
+
+/**
+ * Clears the private manager and the request stack.
+ */
+void SoftwareTimer_ConcurrentInit(SoftwareTimer_Concurrent * concurrent)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    SoftwareTimer_ManagerInit(&concurrent->manager);
+    atomic_init(&concurrent->pending, NULL);
+    concurrent->wake = NULL;
+    concurrent->wakeContext = NULL;
+}
+
+/**
+ * Stores the wake function.
+ */
+void SoftwareTimer_ConcurrentSetWake(SoftwareTimer_Concurrent * concurrent, void (*wake)(void * context), void * context)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    concurrent->wake = wake;
+    concurrent->wakeContext = context;
+}
+
+/**
+ * Initializes the embedded entry and the state word.
+ */
+void SoftwareTimer_ConcurrentEntryInit(SoftwareTimer_ConcurrentEntry * entry, SoftwareTimer_Callback callback, void * context)
+{
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    SoftwareTimer_EntryInit(&entry->entry, callback, context);
+    atomic_init(&entry->state, STATE_IDLE);
+    atomic_init(&entry->requestStart, 0);
+    atomic_init(&entry->requestInterval, 0);
+    atomic_init(&entry->requestPeriod, 0);
+    entry->pendingNext = NULL;
+}
+
+/**
+ * Publishes a one-shot arm request.
+ */
+bool SoftwareTimer_ConcurrentArm(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t interval)
+{
+    return concurrent_arm(concurrent, entry, interval, 0);
+}
+
+/**
+ * Publishes a periodic arm request.
+ */
+bool SoftwareTimer_ConcurrentArmPeriodic(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(period > 0);
+    return concurrent_arm(concurrent, entry, period, period);
+}
+
+/**
+ * Publishes a cancel request. The entry is pushed as well, so that the
+ * processing thread unlinks it before its deadline.
+ */
+void SoftwareTimer_ConcurrentCancel(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    uint32_t previous;
+
+    entry_claim(entry);
+    entry_publish(concurrent, entry, STATE_CANCELLED, &previous);
+}
+
+/**
+ * Publishes a cancel request and waits for the processing thread to finish
+ * the callback and apply the request.
+ *
+ * Implementation:
+ * - An entry that is neither on the stack, firing nor armed is not
+ *   referenced by the processing thread; WRITING is released without a
+ *   request and nothing is waited for
+ * - FIRING is only set while WRITING is clear, so holding WRITING makes the
+ *   decision between "prevented" and "waited" race-free
+ * - The processing thread is always woken: even when the entry was already
+ *   on the stack, it may have been pushed back while WRITING was held and
+ *   the processing thread may be asleep
+ */
+SoftwareTimer_CancelResult SoftwareTimer_ConcurrentCancelSync(SoftwareTimer_Concurrent * concurrent, SoftwareTimer_ConcurrentEntry * entry)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    uint32_t previous;
+
+    entry_claim(entry);
+    previous = atomic_load_explicit(&entry->state, memory_order_relaxed);
+    uint32_t status = previous & STATE_STATUS_MASK;
+    if ((previous & (STATE_ON_STACK | STATE_FIRING)) == 0 && (status == STATE_IDLE || status == STATE_CANCELLED)) {
+        entry_release(entry);
+        return SOFTWARETIMER_CANCEL_INACTIVE;
+    }
+
+    entry_publish(concurrent, entry, STATE_CANCELLED, &previous);
+    if (concurrent->wake != NULL)
+        concurrent->wake(concurrent->wakeContext);
+    while ((atomic_load_explicit(&entry->state, memory_order_acquire) & (STATE_ON_STACK | STATE_FIRING)) != 0) {
+    }
+
+    status = previous & STATE_STATUS_MASK;
+    if ((previous & STATE_FIRING) != 0)
+        return SOFTWARETIMER_CANCEL_WAITED;
+    if (status == STATE_REQUESTED || status == STATE_ARMED)
+        return SOFTWARETIMER_CANCEL_PREVENTED;
+    return SOFTWARETIMER_CANCEL_INACTIVE;
+}
+
+/**
+ * Applies requests, fires due entries whose latest request is still the
+ * applied arm request and applies requests made by the callbacks.
+ *
+ * Implementation:
+ * - The clock is read once after the first drain
+ * - An expired entry with a newer request (or being written) is unlinked
+ *   without firing; the newer request is applied from the stack
+ * - FIRING is cleared by the last access to the entry after its callback
+ * - Returns 0 if the last drain pushed back an entry being written, since
+ *   its writer will not wake the processing thread
+ */
+uint32_t SoftwareTimer_ConcurrentProcess(SoftwareTimer_Concurrent * concurrent)
+{
+    SOFTWARETIMER_ASSERT(concurrent != NULL);
+    SoftwareTimer_Entry * expired;
+
+    concurrent_drain(concurrent);
+    uint32_t now = SoftwareTimer_Now();
+
+    while ((expired = SoftwareTimer_ManagerPopExpired(&concurrent->manager, now)) != NULL) {
+        SoftwareTimer_ConcurrentEntry * entry = (SoftwareTimer_ConcurrentEntry *) expired;
+
+        if (!entry_begin_fire(entry)) {
+            SoftwareTimer_ManagerStop(&concurrent->manager, expired);
+            continue;
+        }
+        expired->callback(expired);
+        atomic_fetch_and_explicit(&entry->state, ~STATE_FIRING, memory_order_release);
+    }
+
+    if (!concurrent_drain(concurrent))
+        return 0;
+    const SoftwareTimer_Entry * head = concurrent->manager.head;
+    if (head == NULL)
+        return SOFTWARETIMER_NO_DEADLINE;
+    int32_t remaining = (int32_t) (head->timer.start + head->timer.interval + head->alignment - now);
+    return remaining > 0 ? (uint32_t) remaining : 0;
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_concurrent_disabled;
+
+#endif // C11 atomics
@@ -0,0 +1,111 @@
+/**
+ * @file software_timer_context.c
+ * @brief Deadline propagation contexts implementation
+ * @author Richard Kubíček
+ *
+ * Every context links to its parent and remembers the parent's generation.
+ * A context is valid while it is not cancelled and every link up to the root
+ * still carries the generation recorded at creation.
+ *
+ * @see software_timer_context.h for API documentation
+ */
+
+#include "software_timer_context.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_context
+ * @{
+ */
+
+/**
+ * Returns true if the context and all of its ancestors are neither
+ * cancelled nor re-initialized.
+ */
+static bool context_is_valid(const SoftwareTimer_Context * context)
+{
+    if (context->cancelled)
+        return false;
+
+    while (context->parent != NULL) {
+        if (context->parent->generation != context->parentGeneration)
+            return false;
+        context = context->parent;
+    }
+    return true;
+}
+
+/**
+ * Returns ticks left at @p now, or 0 if the context is done.
+ */
+static uint32_t context_remaining(const SoftwareTimer_Context * context, uint32_t now)
+{
+    if (!context_is_valid(context))
+        return 0;
+
+    uint32_t elapsed = now - context->deadline.start;
+    return elapsed >= context->deadline.interval ? 0 : context->deadline.interval - elapsed;
+}
+
+/**
+ * Links the context to its parent and computes the effective deadline.
+ *
+ * Implementation details:
+ * - The clock is read once; the parent's remaining time is evaluated at the
+ *   same timestamp so that the child can never end after the parent
+ * - The generation is advanced, invalidating children of a previous use
+ */
+void SoftwareTimer_ContextInit(SoftwareTimer_Context * context, const SoftwareTimer_Context * parent, uint32_t timeout)
+{
+    SOFTWARETIMER_ASSERT(context != NULL);
+    SOFTWARETIMER_ASSERT(context != parent);
+    uint32_t now = SoftwareTimer_Now();
+
+    context->generation++;
+    context->cancelled = false;
+    context->parent = parent;
+    context->parentGeneration = 0;
+    context->deadline.start = now;
+    context->deadline.interval = timeout;
+    context->deadline.evaluated = false;
+
+    if (parent != NULL) {
+        uint32_t limit = context_remaining(parent, now);
+        context->parentGeneration = parent->generation;
+        if (limit < timeout)
+            context->deadline.interval = limit;
+        if (limit == 0)
+            context->cancelled = true;
+    }
+}
+
+/**
+ * Marks the context cancelled and advances its generation.
+ */
+void SoftwareTimer_ContextCancel(SoftwareTimer_Context * context)
+{
+    SOFTWARETIMER_ASSERT(context != NULL);
+    context->cancelled = true;
+    context->generation++;
+}
+
+/**
+ * Checks validity and the effective deadline.
+ */
+bool SoftwareTimer_ContextIsDone(const SoftwareTimer_Context * context)
+{
+    SOFTWARETIMER_ASSERT(context != NULL);
+    return context_remaining(context, SoftwareTimer_Now()) == 0;
+}
+
+/**
+ * Returns remaining time of a valid context.
+ */
+uint32_t SoftwareTimer_ContextRemaining(const SoftwareTimer_Context * context)
+{
+    SOFTWARETIMER_ASSERT(context != NULL);
+    return context_remaining(context, SoftwareTimer_Now());
+}
+
+/** @} */
@@ -0,0 +1,121 @@
+/**
+ * @file software_timer_cyclic.c
+ * @brief Cyclic executive implementation
+ * @author Richard Kubíček
+ *
+ * All scheduling decisions are made by SoftwareTimer_CyclicBuild(); the
+ * run-time part only walks the frame table.
+ *
+ * @see software_timer_cyclic.h for API documentation
+ */
+
+#include "software_timer_cyclic.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_cyclic
+ * @{
+ */
+
+/**
+ * Validates the task set and sets the bits of every task in its frames.
+ *
+ * Implementation:
+ * - The major frame is the longest period; every other period must divide
+ *   it, which for a task set means the periods are harmonic in the sense a
+ *   frame table needs
+ * - Each task walks only its own frames, O(sum of major / period)
+ */
+uint32_t SoftwareTimer_CyclicBuild(const SoftwareTimer_CyclicTask * tasks, uint32_t count, uint32_t * frames, uint32_t capacity)
+{
+    SOFTWARETIMER_ASSERT(tasks != NULL);
+    SOFTWARETIMER_ASSERT(frames != NULL);
+    SOFTWARETIMER_ASSERT(count > 0 && count <= SOFTWARETIMER_CYCLIC_MAX_TASKS);
+    uint32_t major = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (tasks[i].period == 0 || tasks[i].offset >= tasks[i].period)
+            return 0;
+        if (tasks[i].period > major)
+            major = tasks[i].period;
+    }
+    if (major > capacity)
+        return 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (major % tasks[i].period != 0)
+            return 0;
+    }
+
+    for (uint32_t f = 0; f < major; f++) {
+        frames[f] = 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t f = tasks[i].offset; f < major; f += tasks[i].period) {
+            frames[f] |= 1u << i;
+        }
+    }
+    return major;
+}
+
+/**
+ * Stores the tables and makes frame 0 due now.
+ */
+void SoftwareTimer_CyclicStart(SoftwareTimer_Cyclic * cyclic, const SoftwareTimer_CyclicTask * tasks, const uint32_t * frames, uint32_t frameCount,
+                               uint32_t minorFrame)
+{
+    SOFTWARETIMER_ASSERT(cyclic != NULL);
+    SOFTWARETIMER_ASSERT(tasks != NULL);
+    SOFTWARETIMER_ASSERT(frames != NULL);
+    SOFTWARETIMER_ASSERT(frameCount > 0);
+    SOFTWARETIMER_ASSERT(minorFrame > 0 && minorFrame <= INT32_MAX);
+
+    cyclic->tasks = tasks;
+    cyclic->frames = frames;
+    cyclic->frameCount = frameCount;
+    cyclic->minorFrame = minorFrame;
+    cyclic->frame = 0;
+    cyclic->next = SoftwareTimer_Now();
+    cyclic->overruns = 0;
+    cyclic->lastOverrun = SOFTWARETIMER_CYCLIC_NO_OVERRUN;
+}
+
+/**
+ * Runs the tasks of the due frame and checks it against the next start.
+ *
+ * Implementation:
+ * - The next start is advanced by exactly one minor frame, keeping the grid
+ *   even when the frame started late
+ * - Bits are consumed lowest first, so tasks run in declaration order and
+ *   the loop ends with the last task of the frame
+ * - The frame overran if the clock reached the next start before the tasks
+ *   returned
+ */
+uint32_t SoftwareTimer_CyclicPoll(SoftwareTimer_Cyclic * cyclic)
+{
+    SOFTWARETIMER_ASSERT(cyclic != NULL);
+    int32_t remaining = (int32_t) (cyclic->next - SoftwareTimer_Now());
+
+    if (remaining > 0)
+        return (uint32_t) remaining;
+
+    uint32_t frame = cyclic->frame;
+    uint32_t mask = cyclic->frames[frame];
+    cyclic->next += cyclic->minorFrame;
+    if (++cyclic->frame == cyclic->frameCount)
+        cyclic->frame = 0;
+
+    for (uint32_t i = 0; mask != 0; i++, mask >>= 1) {
+        if ((mask & 1u) != 0)
+            cyclic->tasks[i].function(cyclic->tasks[i].context);
+    }
+
+    remaining = (int32_t) (cyclic->next - SoftwareTimer_Now());
+    if (remaining > 0)
+        return (uint32_t) remaining;
+    cyclic->overruns++;
+    cyclic->lastOverrun = frame;
+    return 0;
+}
+
+/** @} */
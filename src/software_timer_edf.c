@@ -0,0 +1,181 @@
+/**
+ * @file software_timer_edf.c
+ * @brief Earliest-deadline-first job executor implementation
+ * @author Richard Kubíček
+ *
+ * Pending jobs form a binary min-heap keyed by absolute deadline. Deadlines
+ * are ordered through the signed difference of their absolute values, which
+ * stays correct across a clock wrap while all deadlines are within INT32_MAX
+ * ticks of each other.
+ *
+ * @see software_timer_edf.h for API documentation
+ */
+
+#include "software_timer_edf.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_edf
+ * @{
+ */
+
+/**
+ * Returns the absolute deadline of a job.
+ */
+static uint32_t job_deadline(const SoftwareTimer_Job * job)
+{
+    return job->deadline.start + job->deadline.interval;
+}
+
+/**
+ * Returns true if job @p a is due before job @p b.
+ */
+static bool job_before(const SoftwareTimer_Job * a, const SoftwareTimer_Job * b)
+{
+    return (int32_t) (job_deadline(a) - job_deadline(b)) < 0;
+}
+
+/**
+ * Moves the job at @p index towards the root until the heap order holds.
+ */
+static void heap_sift_up(SoftwareTimer_Edf * edf, uint32_t index)
+{
+    SoftwareTimer_Job * job = edf->heap[index];
+
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (!job_before(job, edf->heap[parent]))
+            break;
+        edf->heap[index] = edf->heap[parent];
+        index = parent;
+    }
+    edf->heap[index] = job;
+}
+
+/**
+ * Moves the job at @p index towards the leaves until the heap order holds.
+ */
+static void heap_sift_down(SoftwareTimer_Edf * edf, uint32_t index)
+{
+    SoftwareTimer_Job * job = edf->heap[index];
+
+    while (1) {
+        uint32_t child = 2 * index + 1;
+        if (child >= edf->count)
+            break;
+        if (child + 1 < edf->count && job_before(edf->heap[child + 1], edf->heap[child]))
+            child++;
+        if (!job_before(edf->heap[child], job))
+            break;
+        edf->heap[index] = edf->heap[child];
+        index = child;
+    }
+    edf->heap[index] = job;
+}
+
+/**
+ * Stores the heap storage and clears the backlog.
+ */
+void SoftwareTimer_EdfInit(SoftwareTimer_Edf * edf, SoftwareTimer_Job ** storage, uint32_t capacity)
+{
+    SOFTWARETIMER_ASSERT(edf != NULL);
+    SOFTWARETIMER_ASSERT(storage != NULL);
+    edf->heap = storage;
+    edf->capacity = capacity;
+    edf->count = 0;
+    edf->backlog = 0;
+}
+
+/**
+ * Stores the job body and its cost estimate.
+ */
+void SoftwareTimer_JobInit(SoftwareTimer_Job * job, SoftwareTimer_JobFunction function, void * context, uint32_t cost)
+{
+    SOFTWARETIMER_ASSERT(job != NULL);
+    SOFTWARETIMER_ASSERT(function != NULL);
+    job->deadline.start = 0;
+    job->deadline.interval = 0;
+    job->deadline.evaluated = false;
+    job->cost = cost;
+    job->function = function;
+    job->context = context;
+}
+
+/**
+ * Runs the admission test and pushes the job onto the heap.
+ *
+ * Implementation:
+ * - Work ahead of the new job is the cost of pending jobs due no later
+ *   than it; together with its own cost it must fit into its deadline
+ * - For pending jobs due later, the whole backlog plus the new cost is an
+ *   upper bound of their completion time; jobs that did not fit even before
+ *   are ignored so that one late job does not block all admissions
+ */
+SoftwareTimer_EdfResult SoftwareTimer_EdfSubmit(SoftwareTimer_Edf * edf, SoftwareTimer_Job * job, uint32_t deadline)
+{
+    SOFTWARETIMER_ASSERT(edf != NULL);
+    SOFTWARETIMER_ASSERT(job != NULL);
+    SOFTWARETIMER_ASSERT(deadline <= INT32_MAX);
+
+    if (edf->count == edf->capacity)
+        return SOFTWARETIMER_EDF_FULL;
+
+    uint32_t now = SoftwareTimer_Now();
+    uint32_t absolute = now + deadline;
+    uint64_t ahead = job->cost;
+    uint64_t worst = (uint64_t) edf->backlog + job->cost;
+
+    for (uint32_t i = 0; i < edf->count; i++) {
+        const SoftwareTimer_Job * pending = edf->heap[i];
+        int32_t slack = (int32_t) (job_deadline(pending) - now);
+
+        if ((int32_t) (job_deadline(pending) - absolute) <= 0) {
+            ahead += pending->cost;
+        } else if (slack >= 0 && edf->backlog <= (uint32_t) slack && worst > (uint32_t) slack) {
+            return SOFTWARETIMER_EDF_REJECTED;
+        }
+    }
+    if (ahead > deadline)
+        return SOFTWARETIMER_EDF_REJECTED;
+
+    job->deadline.start = now;
+    job->deadline.interval = deadline;
+    job->deadline.evaluated = false;
+    edf->heap[edf->count] = job;
+    edf->count++;
+    edf->backlog += job->cost;
+    heap_sift_up(edf, edf->count - 1);
+    return SOFTWARETIMER_EDF_ACCEPTED;
+}
+
+/**
+ * Pops the heap root and runs it.
+ */
+bool SoftwareTimer_EdfRunNext(SoftwareTimer_Edf * edf)
+{
+    SOFTWARETIMER_ASSERT(edf != NULL);
+    if (edf->count == 0)
+        return false;
+
+    SoftwareTimer_Job * job = edf->heap[0];
+    edf->count--;
+    if (edf->count > 0) {
+        edf->heap[0] = edf->heap[edf->count];
+        heap_sift_down(edf, 0);
+    }
+    edf->backlog -= job->cost;
+    job->function(job);
+    return true;
+}
+
+/**
+ * Returns the heap size.
+ */
+uint32_t SoftwareTimer_EdfPending(const SoftwareTimer_Edf * edf)
+{
+    SOFTWARETIMER_ASSERT(edf != NULL);
+    return edf->count;
+}
+
+/** @} */
@@ -0,0 +1,161 @@
+/**
+ * @file software_timer_freertos.c
+ * @brief FreeRTOS integration implementation
+ * @author Richard Kubíček
+ *
+ * A single manager is shared by the application. Tasks modify it inside
+ * kernel critical sections and the tick hook reads the head of the list
+ * inside the ISR variant of the same critical section, which also covers
+ * SMP ports where the tick interrupt runs on another core.
+ *
+ * Compiled only when SOFTWARETIMER_FREERTOS is defined.
+ *
+ * @see software_timer_freertos.h for API documentation
+ */
+
+#ifdef SOFTWARETIMER_FREERTOS
+
+    #include "software_timer_freertos.h"
+    #include "software_timer_private.h"
+    #include <stddef.h>
+
+    #if (defined(configUSE_16_BIT_TICKS) && configUSE_16_BIT_TICKS == 1) || (defined(configTICK_TYPE_WIDTH_IN_BITS) && configTICK_TYPE_WIDTH_IN_BITS != TICK_TYPE_WIDTH_32_BITS)
+        #error "SoftwareTimer FreeRTOS integration requires 32-bit ticks"
+    #endif
+
+/**
+ * @addtogroup software_timer_freertos
+ * @{
+ */
+
+/**
+ * @var manager
+ * @brief Manager shared by the tick hook, the idle hook and the processing task
+ */
+static SoftwareTimer_Manager manager;
+
+/**
+ * @var processingTask
+ * @brief Task notified by the tick hook when an entry is due
+ */
+static TaskHandle_t processingTask;
+
+/**
+ * Clock source: the RTOS tick count.
+ */
+static uint32_t freertos_clock(void)
+{
+    return (uint32_t) xTaskGetTickCount();
+}
+
+/**
+ * Registers the tick count as clock source and clears the manager.
+ */
+void SoftwareTimer_FreeRtosInit(void)
+{
+    SoftwareTimer_Init(freertos_clock);
+    SoftwareTimer_ManagerInit(&manager);
+    processingTask = NULL;
+}
+
+/**
+ * Stores the handle of the processing task.
+ */
+void SoftwareTimer_FreeRtosSetTask(TaskHandle_t task)
+{
+    taskENTER_CRITICAL();
+    processingTask = task;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Arms the entry inside a critical section.
+ */
+void SoftwareTimer_FreeRtosStart(SoftwareTimer_Entry * entry, uint32_t ticks)
+{
+    taskENTER_CRITICAL();
+    SoftwareTimer_ManagerStart(&manager, entry, ticks);
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Arms the periodic entry inside a critical section.
+ */
+void SoftwareTimer_FreeRtosStartPeriodic(SoftwareTimer_Entry * entry, uint32_t ticks)
+{
+    taskENTER_CRITICAL();
+    SoftwareTimer_ManagerStartPeriodic(&manager, entry, ticks);
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Disarms the entry inside a critical section.
+ */
+void SoftwareTimer_FreeRtosStop(SoftwareTimer_Entry * entry)
+{
+    taskENTER_CRITICAL();
+    SoftwareTimer_ManagerStop(&manager, entry);
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Compares the current tick with the earliest deadline.
+ *
+ * Implementation details:
+ * - Only the list head is inspected, one comparison per tick, inside
+ *   taskENTER_CRITICAL_FROM_ISR()
+ * - vTaskNotifyGiveFromISR() is passed NULL for the "higher priority task
+ *   woken" flag, which makes the kernel set its pending-yield flag so the
+ *   tick interrupt switches to the processing task if required
+ */
+void SoftwareTimer_FreeRtosTickHook(void)
+{
+    UBaseType_t critical = taskENTER_CRITICAL_FROM_ISR();
+    const SoftwareTimer_Entry * head = manager.head;
+    TaskHandle_t task = processingTask;
+    bool due = head != NULL && task != NULL &&
+               (int32_t) (head->timer.start + head->timer.interval + head->alignment - (uint32_t) xTaskGetTickCountFromISR()) <= 0;
+    taskEXIT_CRITICAL_FROM_ISR(critical);
+
+    if (due)
+        vTaskNotifyGiveFromISR(task, NULL);
+}
+
+/**
+ * Returns the smaller of the kernel's idle estimate and the next deadline.
+ */
+TickType_t SoftwareTimer_FreeRtosExpectedIdle(TickType_t expected)
+{
+    uint32_t next = SoftwareTimer_ManagerNextDeadline(&manager);
+    return next < (uint32_t) expected ? (TickType_t) next : expected;
+}
+
+/**
+ * Waits for the tick hook and fires expired entries one by one. The list is
+ * only modified inside a critical section; callbacks run outside of it.
+ */
+void SoftwareTimer_FreeRtosTaskLoop(void)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t now = SoftwareTimer_Now();
+
+        for (;;) {
+            taskENTER_CRITICAL();
+            SoftwareTimer_Entry * entry = SoftwareTimer_ManagerPopExpired(&manager, now);
+            taskEXIT_CRITICAL();
+            if (entry == NULL)
+                break;
+            entry->callback(entry);
+        }
+    }
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_freertos_disabled;
+
+#endif // SOFTWARETIMER_FREERTOS
@@ -0,0 +1,221 @@
+/**
+ * @file software_timer_fsm.c
+ * @brief State-machine timeouts implementation
+ * @author Richard Kubíček
+ *
+ * The slot is a manager entry in all modes. With a manager it is armed in
+ * the manager; without one only its embedded timer is used and polled. With
+ * queues the slot's timer holds the deadline and its next/prev pointers
+ * link it into the queue of its state, while only the queue entries are
+ * linked in the manager. In every mode timer.evaluated marks a slot that is
+ * not armed.
+ *
+ * @see software_timer_fsm.h for API documentation
+ */
+
+#include "software_timer_fsm.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_fsm
+ * @{
+ */
+
+/**
+ * Manager callback of the slot. The slot is the first member of the
+ * machine, so the entry pointer is the machine pointer.
+ */
+static void fsm_expired(SoftwareTimer_Entry * entry)
+{
+    SoftwareTimer_Fsm * fsm = (SoftwareTimer_Fsm *) entry;
+    fsm->table->onTimeout(fsm, fsm->state);
+}
+
+/**
+ * Arms the queue entry for the deadline of the head slot.
+ */
+static void queue_arm(SoftwareTimer_FsmQueue * queue)
+{
+    SoftwareTimer_ManagerStartFrom(queue->table->manager, &queue->entry, queue->head->timer.start, queue->head->timer.interval, 0);
+}
+
+/**
+ * Appends an armed slot; the queue entry is armed when the queue was empty.
+ */
+static void queue_append(SoftwareTimer_FsmQueue * queue, SoftwareTimer_Entry * slot)
+{
+    slot->next = NULL;
+    slot->prev = queue->tail;
+    if (queue->tail != NULL) {
+        queue->tail->next = slot;
+        queue->tail = slot;
+        return;
+    }
+    queue->head = slot;
+    queue->tail = slot;
+    queue_arm(queue);
+}
+
+/**
+ * Unlinks a slot and disarms it, moving the dispatch cursor back past it.
+ * The queue entry is stopped when the queue becomes empty; otherwise it
+ * stays armed for the earlier deadline and re-arms when it fires.
+ */
+static void queue_unlink(SoftwareTimer_FsmQueue * queue, SoftwareTimer_Entry * slot)
+{
+    if (queue->cursor == slot)
+        queue->cursor = slot->prev;
+    if (slot->prev != NULL)
+        slot->prev->next = slot->next;
+    else
+        queue->head = slot->next;
+    if (slot->next != NULL)
+        slot->next->prev = slot->prev;
+    else
+        queue->tail = slot->prev;
+    slot->next = NULL;
+    slot->prev = NULL;
+    slot->timer.evaluated = true;
+
+    if (queue->head == NULL)
+        SoftwareTimer_ManagerStop(queue->table->manager, &queue->entry);
+}
+
+/**
+ * Manager callback of a queue entry: times out the due machines at the head.
+ *
+ * Implementation details:
+ * - The clock is read once, as in SoftwareTimer_ManagerProcess()
+ * - The cursor marks the last slot queued before the dispatch. Timeout
+ *   callbacks may re-enter the same state, which appends behind the
+ *   cursor, or stop any machine; unlinking the slot under the cursor moves
+ *   it back, and unlinking the head with the cursor on it ends the batch
+ * - An entry that fired for a head which has left the state finds no due
+ *   slot and only re-arms for the new head
+ */
+static void queue_expired(SoftwareTimer_Entry * entry)
+{
+    SoftwareTimer_FsmQueue * queue = (SoftwareTimer_FsmQueue *) entry;
+    uint32_t now = SoftwareTimer_Now();
+    SoftwareTimer_Entry * slot;
+
+    queue->cursor = queue->tail;
+    while (queue->cursor != NULL && (slot = queue->head) != NULL && now - slot->timer.start >= slot->timer.interval) {
+        SoftwareTimer_Fsm * fsm = (SoftwareTimer_Fsm *) slot;
+        queue_unlink(queue, slot);
+        queue->table->onTimeout(fsm, fsm->state);
+    }
+    queue->cursor = NULL;
+
+    if (queue->head != NULL && !SoftwareTimer_EntryIsActive(&queue->entry))
+        queue_arm(queue);
+}
+
+/**
+ * Initializes every queue as empty with a not armed entry.
+ */
+void SoftwareTimer_FsmQueuesInit(const SoftwareTimer_FsmTable * table)
+{
+    SOFTWARETIMER_ASSERT(table != NULL);
+    SOFTWARETIMER_ASSERT(table->manager != NULL);
+    SOFTWARETIMER_ASSERT(table->queues != NULL);
+
+    for (uint32_t i = 0; i < table->stateCount; i++) {
+        SoftwareTimer_FsmQueue * queue = &table->queues[i];
+        SoftwareTimer_EntryInit(&queue->entry, queue_expired, NULL);
+        queue->table = table;
+        queue->head = NULL;
+        queue->tail = NULL;
+        queue->cursor = NULL;
+    }
+}
+
+/**
+ * Initializes the slot as not armed and enters the initial state.
+ */
+void SoftwareTimer_FsmInit(SoftwareTimer_Fsm * fsm, const SoftwareTimer_FsmTable * table, void * context, uint32_t initialState)
+{
+    SOFTWARETIMER_ASSERT(fsm != NULL);
+    SOFTWARETIMER_ASSERT(table != NULL);
+    SOFTWARETIMER_ASSERT(table->timeouts != NULL);
+    SOFTWARETIMER_ASSERT(table->onTimeout != NULL);
+    SOFTWARETIMER_ASSERT(table->queues == NULL || table->manager != NULL);
+
+    SoftwareTimer_EntryInit(&fsm->slot, fsm_expired, context);
+    fsm->table = table;
+    SoftwareTimer_FsmEnter(fsm, initialState);
+}
+
+/**
+ * Cancels the previous timeout and arms the slot from the table.
+ *
+ * Implementation details:
+ * - With queues the slot is unlinked from the queue of the previous state
+ *   before the state changes, then appended to the queue of the new one
+ * - With a manager the slot is re-linked by SoftwareTimer_ManagerStart(),
+ *   which unlinks a still armed slot first
+ * - Without a manager SoftwareTimer_Set() clears the evaluated flag, which
+ *   arms the slot for SoftwareTimer_FsmPoll()
+ */
+void SoftwareTimer_FsmEnter(SoftwareTimer_Fsm * fsm, uint32_t state)
+{
+    SOFTWARETIMER_ASSERT(fsm != NULL);
+    SOFTWARETIMER_ASSERT(state < fsm->table->stateCount);
+    uint32_t timeout = fsm->table->timeouts[state];
+
+    if (fsm->table->queues != NULL)
+        SoftwareTimer_FsmStop(fsm);
+    fsm->state = state;
+    if (timeout == SOFTWARETIMER_FSM_NO_TIMEOUT) {
+        SoftwareTimer_FsmStop(fsm);
+    } else if (fsm->table->queues != NULL) {
+        SoftwareTimer_Set(&fsm->slot.timer, timeout);
+        queue_append(&fsm->table->queues[state], &fsm->slot);
+    } else if (fsm->table->manager != NULL) {
+        SoftwareTimer_ManagerStart(fsm->table->manager, &fsm->slot, timeout);
+    } else {
+        SoftwareTimer_Set(&fsm->slot.timer, timeout);
+    }
+}
+
+/**
+ * Returns the stored state.
+ */
+uint32_t SoftwareTimer_FsmState(const SoftwareTimer_Fsm * fsm)
+{
+    SOFTWARETIMER_ASSERT(fsm != NULL);
+    return fsm->state;
+}
+
+/**
+ * Evaluates the slot once and calls the timeout callback.
+ */
+bool SoftwareTimer_FsmPoll(SoftwareTimer_Fsm * fsm)
+{
+    SOFTWARETIMER_ASSERT(fsm != NULL);
+    SOFTWARETIMER_ASSERT(fsm->table->manager == NULL);
+
+    if (!SoftwareTimer_IsExpiredEvaluatedOnce(&fsm->slot.timer))
+        return false;
+    fsm_expired(&fsm->slot);
+    return true;
+}
+
+/**
+ * Unlinks the slot from the queue of the current state, disarms it in the
+ * manager or marks the polled slot as evaluated.
+ */
+void SoftwareTimer_FsmStop(SoftwareTimer_Fsm * fsm)
+{
+    SOFTWARETIMER_ASSERT(fsm != NULL);
+    if (fsm->table->queues != NULL) {
+        if (!fsm->slot.timer.evaluated)
+            queue_unlink(&fsm->table->queues[fsm->state], &fsm->slot);
+    } else if (fsm->table->manager != NULL)
+        SoftwareTimer_ManagerStop(fsm->table->manager, &fsm->slot);
+    else
+        fsm->slot.timer.evaluated = true;
+}
+
+/** @} */
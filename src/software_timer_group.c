@@ -0,0 +1,164 @@
+/**
+ * @file software_timer_group.c
+ * @brief Delta-compressed timer groups implementation
+ * @author Richard Kubíček
+ *
+ * Member start times are base + offset. Running members never started
+ * before the base, so offsets are never negative; the rebase preserves this
+ * by moving the base only up to the oldest running member.
+ *
+ * @see software_timer_group.h for API documentation
+ */
+
+#include "software_timer_group.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_group
+ * @{
+ */
+
+/**
+ * @def GROUP_STOPPED
+ * @brief Interval value marking a stopped member
+ */
+#define GROUP_STOPPED UINT16_MAX
+
+/**
+ * Returns true if @p member is running and expired at @p now.
+ */
+static bool member_is_expired(const SoftwareTimer_Group * group, const SoftwareTimer_GroupMember * member, uint32_t now)
+{
+    return member->interval != GROUP_STOPPED && now - (group->base + member->offset) >= member->interval;
+}
+
+/**
+ * Returns the time since a running member started, capped at its interval.
+ */
+static uint32_t member_age(const SoftwareTimer_Group * group, const SoftwareTimer_GroupMember * member, uint32_t now)
+{
+    uint32_t age = now - (group->base + member->offset);
+    return age > member->interval ? member->interval : age;
+}
+
+/**
+ * Moves the base so that a member started at @p now gets a 16-bit offset.
+ *
+ * Implementation:
+ * - Expired members are re-based to start exactly one interval before
+ *   @p now, which keeps them expired
+ * - Every other running member started less than its interval, and thus
+ *   less than 65535 ticks, before @p now
+ * - The new base is the earliest of those starts (or @p now), so all
+ *   offsets including the new member's fit into 16 bits
+ */
+static void group_rebase(SoftwareTimer_Group * group, uint32_t now)
+{
+    uint32_t oldest = 0;
+
+    for (uint32_t i = 0; i < group->count; i++) {
+        SoftwareTimer_GroupMember * member = &group->members[i];
+        if (member->interval == GROUP_STOPPED)
+            continue;
+        uint32_t age = member_age(group, member, now);
+        if (age > oldest)
+            oldest = age;
+    }
+
+    uint32_t base = now - oldest;
+    for (uint32_t i = 0; i < group->count; i++) {
+        SoftwareTimer_GroupMember * member = &group->members[i];
+        if (member->interval == GROUP_STOPPED)
+            continue;
+        member->offset = (uint16_t) (now - member_age(group, member, now) - base);
+    }
+    group->base = base;
+}
+
+/**
+ * Marks every member stopped and takes the current time as base.
+ */
+void SoftwareTimer_GroupInit(SoftwareTimer_Group * group, SoftwareTimer_GroupMember * members, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    SOFTWARETIMER_ASSERT(members != NULL);
+
+    group->base = SoftwareTimer_Now();
+    group->members = members;
+    group->count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        members[i].offset = 0;
+        members[i].interval = GROUP_STOPPED;
+    }
+}
+
+/**
+ * Stores the start as offset from the base, rebasing first if the offset
+ * does not fit into 16 bits.
+ */
+void SoftwareTimer_GroupSet(SoftwareTimer_Group * group, uint32_t index, uint16_t interval)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    SOFTWARETIMER_ASSERT(index < group->count);
+    SOFTWARETIMER_ASSERT(interval <= SOFTWARETIMER_GROUP_MAX_INTERVAL);
+    uint32_t now = SoftwareTimer_Now();
+
+    group->members[index].interval = GROUP_STOPPED;
+    if (now - group->base > UINT16_MAX)
+        group_rebase(group, now);
+    group->members[index].offset = (uint16_t) (now - group->base);
+    group->members[index].interval = interval;
+}
+
+/**
+ * Marks the member stopped.
+ */
+void SoftwareTimer_GroupStop(SoftwareTimer_Group * group, uint32_t index)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    SOFTWARETIMER_ASSERT(index < group->count);
+    group->members[index].interval = GROUP_STOPPED;
+}
+
+/**
+ * Compares the elapsed time of a running member with its interval.
+ */
+bool SoftwareTimer_GroupIsExpired(const SoftwareTimer_Group * group, uint32_t index)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    SOFTWARETIMER_ASSERT(index < group->count);
+    return member_is_expired(group, &group->members[index], SoftwareTimer_Now());
+}
+
+/**
+ * Computes interval minus elapsed time of a running member.
+ */
+uint32_t SoftwareTimer_GroupRemaining(const SoftwareTimer_Group * group, uint32_t index)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    SOFTWARETIMER_ASSERT(index < group->count);
+    const SoftwareTimer_GroupMember * member = &group->members[index];
+
+    if (member->interval == GROUP_STOPPED)
+        return 0;
+    uint32_t elapsed = SoftwareTimer_Now() - (group->base + member->offset);
+    return elapsed >= member->interval ? 0 : member->interval - elapsed;
+}
+
+/**
+ * Scans the packed member array with a single timestamp.
+ */
+uint32_t SoftwareTimer_GroupNextExpired(const SoftwareTimer_Group * group, uint32_t from)
+{
+    SOFTWARETIMER_ASSERT(group != NULL);
+    uint32_t now = SoftwareTimer_Now();
+
+    for (uint32_t i = from; i < group->count; i++) {
+        if (member_is_expired(group, &group->members[i], now))
+            return i;
+    }
+    return SOFTWARETIMER_GROUP_NONE;
+}
+
+/** @} */
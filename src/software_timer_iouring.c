@@ -0,0 +1,199 @@
+/**
+ * @file software_timer_iouring.c
+ * @brief io_uring timeout backend implementation
+ * @author Richard Kubíček
+ *
+ * At most one timeout request is current. Its user data is tag plus a
+ * sequence number that advances with every new timeout, so a late
+ * completion of a removed timeout is never taken for the current one.
+ * Update and remove requests carry the tag itself; their completions need
+ * no handling, because a timeout that could not be updated or removed has
+ * completed and reports that with its own completion.
+ *
+ * Compiled only when SOFTWARETIMER_IOURING is defined on Linux.
+ *
+ * @see software_timer_iouring.h for API documentation
+ */
+
+#if defined(SOFTWARETIMER_IOURING) && defined(__linux__)
+
+    #if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+        #define _POSIX_C_SOURCE 200809L // read, close
+    #endif
+
+    #include "software_timer_iouring.h"
+    #include "software_timer_private.h"
+    #include <errno.h>
+    #include <stddef.h>
+    #include <string.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+
+/**
+ * @addtogroup software_timer_iouring
+ * @{
+ */
+
+/**
+ * Returns a free SQE, submitting the queued ones once if the queue is full.
+ */
+static struct io_uring_sqe * uring_get_sqe(struct io_uring * ring)
+{
+    struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
+
+    if (sqe == NULL) {
+        io_uring_submit(ring);
+        sqe = io_uring_get_sqe(ring);
+    }
+    return sqe;
+}
+
+/**
+ * Prepares the request that moves the kernel timeout to @p deadline, or
+ * removes it when @p deadline is NULL.
+ *
+ * @return false if no SQE was free
+ */
+static bool uring_prepare(SoftwareTimer_Uring * uring, const struct timespec * deadline)
+{
+    struct io_uring_sqe * sqe = uring_get_sqe(&uring->ring);
+
+    if (sqe == NULL)
+        return false;
+
+    if (deadline == NULL) {
+        io_uring_prep_timeout_remove(sqe, uring->tag + uring->sequence, 0);
+        io_uring_sqe_set_data64(sqe, uring->tag);
+        return true;
+    }
+
+    uring->timeout.tv_sec = deadline->tv_sec;
+    uring->timeout.tv_nsec = deadline->tv_nsec;
+    if (uring->armed) {
+        io_uring_prep_timeout_update(sqe, &uring->timeout, uring->tag + uring->sequence, IORING_TIMEOUT_ABS);
+        io_uring_sqe_set_data64(sqe, uring->tag);
+    } else {
+        uring->sequence = uring->sequence == UINT32_MAX ? 1u : uring->sequence + 1u;
+        io_uring_prep_timeout(sqe, &uring->timeout, 0, IORING_TIMEOUT_ABS);
+        io_uring_sqe_set_data64(sqe, uring->tag + uring->sequence);
+    }
+    return true;
+}
+
+/**
+ * Creates the ring and falls back to a non-blocking timerfd.
+ */
+int SoftwareTimer_UringInit(SoftwareTimer_Uring * uring, SoftwareTimer_Manager * manager, unsigned entries, uint64_t tag)
+{
+    SOFTWARETIMER_ASSERT(uring != NULL);
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(tag <= UINT64_MAX - UINT32_MAX);
+
+    memset(uring, 0, sizeof(*uring));
+    uring->manager = manager;
+    uring->tag = tag;
+    uring->timerfd = -1;
+    if (io_uring_queue_init(entries, &uring->ring, 0) == 0)
+        return 0;
+
+    uring->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    return uring->timerfd < 0 ? -1 : 0;
+}
+
+/**
+ * Releases whichever backend was created.
+ */
+void SoftwareTimer_UringExit(SoftwareTimer_Uring * uring)
+{
+    SOFTWARETIMER_ASSERT(uring != NULL);
+
+    if (uring->timerfd >= 0) {
+        close(uring->timerfd);
+        uring->timerfd = -1;
+    } else {
+        io_uring_queue_exit(&uring->ring);
+    }
+    uring->armed = false;
+}
+
+/**
+ * Re-arms the kernel timer unless it was computed from the current list.
+ *
+ * Implementation:
+ * - The manager's list generation advances with every link and unlink, so
+ *   an unchanged generation means an unchanged earliest deadline
+ * - The generation is read before the deadline: a change in between leaves
+ *   the stored generation behind and the next call re-arms again
+ * - The timerfd is re-armed through @ref SoftwareTimer_TimerfdArm
+ */
+int SoftwareTimer_UringRearm(SoftwareTimer_Uring * uring)
+{
+    SOFTWARETIMER_ASSERT(uring != NULL);
+    struct timespec deadline;
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+    uint32_t generation = uring->manager->generation;
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+
+    if (uring->armed && generation == uring->generation)
+        return 0;
+
+    bool pending = SoftwareTimer_ManagerNextTimespec(uring->manager, &deadline);
+    if (!pending && !uring->armed)
+        return 0;
+
+    if (uring->timerfd >= 0) {
+        if (SoftwareTimer_TimerfdArm(uring->timerfd, uring->manager) < 0)
+            return -1;
+    } else if (!uring_prepare(uring, pending ? &deadline : NULL)) {
+        errno = EBUSY;
+        return -1;
+    }
+    uring->armed = pending;
+    uring->generation = generation;
+    return 0;
+}
+
+/**
+ * Recognizes the module's completions by the reserved user data range.
+ */
+bool SoftwareTimer_UringHandleCqe(SoftwareTimer_Uring * uring, const struct io_uring_cqe * cqe)
+{
+    SOFTWARETIMER_ASSERT(uring != NULL);
+    SOFTWARETIMER_ASSERT(cqe != NULL);
+
+    if (cqe->user_data < uring->tag || cqe->user_data - uring->tag > UINT32_MAX)
+        return false;
+    if (cqe->user_data == uring->tag)
+        return true;
+
+    if (cqe->user_data - uring->tag == uring->sequence)
+        uring->armed = false;
+    if (cqe->res == -ETIME)
+        SoftwareTimer_ManagerProcess(uring->manager);
+    return true;
+}
+
+/**
+ * Consumes the expiration count of the timerfd.
+ */
+bool SoftwareTimer_UringHandleTimerfd(SoftwareTimer_Uring * uring)
+{
+    SOFTWARETIMER_ASSERT(uring != NULL);
+    SOFTWARETIMER_ASSERT(uring->timerfd >= 0);
+    uint64_t expirations;
+
+    if (read(uring->timerfd, &expirations, sizeof(expirations)) != (ssize_t) sizeof(expirations))
+        return false;
+    uring->armed = false;
+    SoftwareTimer_ManagerProcess(uring->manager);
+    return true;
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_iouring_disabled;
+
+#endif // SOFTWARETIMER_IOURING && __linux__
@@ -0,0 +1,508 @@
+/**
+ * @file software_timer_manager.c
+ * @brief Callback timer manager implementation
+ * @author Richard Kubíček
+ *
+ * Armed entries form a doubly linked list sorted by deadline. The earliest
+ * deadline is always at the head, so expiry processing and the next-deadline
+ * query never look past the first not yet expired entry.
+ *
+ * Every access to the list and every update of the statistics is wrapped
+ * in the critical section selected by SOFTWARETIMER_CRITICAL. No user code
+ * runs inside it: callbacks and the visitor of SoftwareTimer_ManagerVisit()
+ * run outside, so they may arm and stop entries, and critical sections
+ * never nest.
+ *
+ * @see software_timer_manager.h for API documentation
+ */
+
+#include "software_timer_manager.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @addtogroup software_timer_manager
+ * @{
+ */
+
+#ifdef SOFTWARETIMER_SPINLOCK_STORAGE
+/**
+ * @var softwaretimer_spinlock
+ * @brief Lock word of the default spinlock strategy, 0 when free
+ */
+volatile uint32_t softwaretimer_spinlock;
+#endif
+
+#if SOFTWARETIMER_CRITICAL == SOFTWARETIMER_CRITICAL_PTHREAD
+/**
+ * @var softwaretimer_mutex
+ * @brief Mutex of the pthread strategy
+ */
+pthread_mutex_t softwaretimer_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**
+ * Returns the absolute deadline of an entry, including the grid alignment.
+ */
+static uint32_t entry_deadline(const SoftwareTimer_Entry * entry)
+{
+    return entry->timer.start + entry->timer.interval + entry->alignment;
+}
+
+#ifdef SOFTWARETIMER_STATS
+/**
+ * Returns the lateness histogram bucket: the bit length of @p lateness,
+ * capped at the last bucket.
+ */
+static uint32_t lateness_bucket(uint32_t lateness)
+{
+    uint32_t bucket = 0;
+
+    while (lateness != 0 && bucket < SOFTWARETIMER_STATS_BUCKETS - 1u) {
+        lateness >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * Counts one expiration that is handed out @p lateness ticks after its deadline.
+ */
+static void manager_count_expiration(SoftwareTimer_Manager * manager, uint32_t lateness)
+{
+    SOFTWARETIMER_STATS_ADD(manager->stats.expirations, 1u);
+    SOFTWARETIMER_STATS_ADD(manager->stats.latenessSum, lateness);
+    SOFTWARETIMER_STATS_ADD(manager->stats.lateness[lateness_bucket(lateness)], 1u);
+}
+#endif
+
+/**
+ * Links an entry into the list in deadline order.
+ *
+ * Implementation details:
+ * - Deadlines are compared through the signed difference, which orders them
+ *   correctly across a clock wrap as long as they are within INT32_MAX ticks
+ * - Entries with equal deadlines keep their arming order (FIFO)
+ * - The grid alignment of a soft entry is recomputed here, so every arm and
+ *   every periodic re-arm picks up the current grid. The grid is a power of
+ *   two and divides 2^32, so it stays aligned across a clock wrap
+ * - Alignment adds up to grid - 1 ticks, so a soft interval is limited to
+ *   INT32_MAX minus that; checked here because a periodic re-arm may meet
+ *   a grid widened after the entry was armed
+ */
+static void manager_link(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry)
+{
+    SOFTWARETIMER_ASSERT(!entry->soft || entry->timer.interval <= INT32_MAX - manager->gridMask);
+    entry->alignment = entry->soft ? (0u - (entry->timer.start + entry->timer.interval)) & manager->gridMask : 0;
+    uint32_t deadline = entry_deadline(entry);
+    SoftwareTimer_Entry * prev = NULL;
+    SoftwareTimer_Entry * cur = manager->head;
+
+    while (cur != NULL && (int32_t) (entry_deadline(cur) - deadline) <= 0) {
+        prev = cur;
+        cur = cur->next;
+    }
+
+    entry->prev = prev;
+    entry->next = cur;
+    if (cur != NULL)
+        cur->prev = entry;
+    if (prev != NULL)
+        prev->next = entry;
+    else
+        manager->head = entry;
+    entry->timer.evaluated = false;
+    manager->generation++;
+#ifdef SOFTWARETIMER_STATS
+    SOFTWARETIMER_STATS_ADD(manager->stats.active, 1u);
+#endif
+}
+
+/**
+ * Removes an armed entry from the list.
+ */
+static void manager_unlink(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry)
+{
+    if (entry->prev != NULL)
+        entry->prev->next = entry->next;
+    else
+        manager->head = entry->next;
+    if (entry->next != NULL)
+        entry->next->prev = entry->prev;
+    entry->next = NULL;
+    entry->prev = NULL;
+    entry->timer.evaluated = true;
+    manager->generation++;
+#ifdef SOFTWARETIMER_STATS
+    SOFTWARETIMER_STATS_SUB(manager->stats.active, 1u);
+#endif
+}
+
+/**
+ * Arms an entry with the given start, first interval, re-arm period and
+ * repeat count (0 for unlimited).
+ */
+static void manager_arm(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t start, uint32_t interval, uint32_t period, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    SOFTWARETIMER_ASSERT(interval <= INT32_MAX);
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+    if (!entry->timer.evaluated)
+        manager_unlink(manager, entry);
+    entry->timer.start = start;
+    entry->timer.interval = interval;
+    entry->period = period;
+    entry->remaining = count;
+    manager_link(manager, entry);
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+}
+
+/**
+ * Clears the list.
+ */
+void SoftwareTimer_ManagerInit(SoftwareTimer_Manager * manager)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    manager->head = NULL;
+    manager->gridMask = 0;
+    manager->generation = 0;
+#ifdef SOFTWARETIMER_STATS
+    memset(&manager->stats, 0, sizeof(manager->stats));
+#endif
+}
+
+/**
+ * Stores the callback and marks the entry as not armed.
+ */
+void SoftwareTimer_EntryInit(SoftwareTimer_Entry * entry, SoftwareTimer_Callback callback, void * context)
+{
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    SOFTWARETIMER_ASSERT(callback != NULL);
+    entry->timer.start = 0;
+    entry->timer.interval = 0;
+    entry->timer.evaluated = true;
+    entry->period = 0;
+    entry->missed = 0;
+    entry->remaining = 0;
+    entry->alignment = 0;
+    entry->soft = false;
+    entry->callback = callback;
+    entry->context = context;
+    entry->next = NULL;
+    entry->prev = NULL;
+#ifdef SOFTWARETIMER_STATS
+    entry->tag = NULL;
+#endif
+}
+
+/**
+ * Arms a one-shot entry, re-linking it if it was already armed.
+ */
+void SoftwareTimer_ManagerStart(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t interval)
+{
+    manager_arm(manager, entry, SoftwareTimer_Now(), interval, 0, 0);
+}
+
+/**
+ * Arms a periodic entry, re-linking it if it was already armed.
+ */
+void SoftwareTimer_ManagerStartPeriodic(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(period > 0);
+    manager_arm(manager, entry, SoftwareTimer_Now(), period, period, 0);
+}
+
+/**
+ * Arms a periodic entry that stops itself after @p count expirations.
+ */
+void SoftwareTimer_ManagerStartRepeating(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t period, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(period > 0);
+    if (count == 0) {
+        SoftwareTimer_ManagerStop(manager, entry);
+        return;
+    }
+    manager_arm(manager, entry, SoftwareTimer_Now(), period, period, count);
+}
+
+/**
+ * Arms an entry from a start time captured by the caller.
+ */
+void SoftwareTimer_ManagerStartFrom(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry, uint32_t start, uint32_t interval, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(period <= INT32_MAX);
+    manager_arm(manager, entry, start, interval, period, 0);
+}
+
+/**
+ * Unlinks the entry if it is armed. The evaluated flag of the embedded
+ * timer doubles as the "not armed" marker, so no list walk is needed.
+ */
+void SoftwareTimer_ManagerStop(SoftwareTimer_Manager * manager, SoftwareTimer_Entry * entry)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+    if (!entry->timer.evaluated)
+        manager_unlink(manager, entry);
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+}
+
+/**
+ * Stores the flag read when the entry is linked next time.
+ */
+void SoftwareTimer_EntrySetSoft(SoftwareTimer_Entry * entry, bool soft)
+{
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    entry->soft = soft;
+}
+
+/**
+ * Stores the grid as a mask; linked entries keep their alignment.
+ */
+void SoftwareTimer_ManagerSetGrid(SoftwareTimer_Manager * manager, uint32_t grid)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT((grid & (grid - 1u)) == 0 && grid <= (1u << 30));
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+    manager->gridMask = grid > 1u ? grid - 1u : 0;
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+}
+
+/**
+ * Returns the inverted "not armed" marker.
+ */
+bool SoftwareTimer_EntryIsActive(const SoftwareTimer_Entry * entry)
+{
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    return !entry->timer.evaluated;
+}
+
+/**
+ * Detaches the head entry if it is due at @p now.
+ *
+ * Implementation:
+ * - Expiry is decided on the signed distance to the deadline, so an entry
+ *   armed after the timestamp was taken is not seen as expired
+ * - The entry is unlinked (one-shot) or re-linked at previous deadline plus
+ *   period (periodic) before it is returned
+ * - A periodic entry that is late by whole periods skips them with one
+ *   division instead of expiring once per missed period; the division is
+ *   only done when at least one period was missed
+ * - Periods continue from the requested deadline, not from the grid-aligned
+ *   one, so alignment never shifts the schedule of a periodic entry
+ * - A repeating entry counts down one per expiration, missed periods
+ *   included in it; the last expiration leaves it unlinked
+ */
+SoftwareTimer_Entry * SoftwareTimer_ManagerPopExpired(SoftwareTimer_Manager * manager, uint32_t now)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+    SoftwareTimer_Entry * entry = manager->head;
+
+    if (entry == NULL || (int32_t) (entry_deadline(entry) - now) > 0) {
+        SOFTWARETIMER_CRITICAL_EXIT(critical);
+        return NULL;
+    }
+
+#ifdef SOFTWARETIMER_STATS
+    manager_count_expiration(manager, now - entry_deadline(entry));
+#endif
+    manager_unlink(manager, entry);
+    if (entry->remaining == 1) {
+        entry->remaining = 0;
+    } else if (entry->period != 0) {
+        if (entry->remaining != 0)
+            entry->remaining--;
+        uint32_t deadline = entry->timer.start + entry->timer.interval;
+        uint32_t late = now - deadline;
+
+        entry->missed = late >= entry->period ? late / entry->period : 0;
+        entry->timer.start = deadline + entry->missed * entry->period;
+        entry->timer.interval = entry->period;
+        manager_link(manager, entry);
+    }
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+    return entry;
+}
+
+/**
+ * Fires expired entries from the head of the list.
+ *
+ * Implementation:
+ * - The clock is read once; every entry is compared against that timestamp
+ * - The head is re-read after every callback because callbacks may arm or
+ *   stop entries
+ * - Each pop enters the critical section on its own, callbacks run with it
+ *   released
+ * - The remaining time is clamped at 0: an entry linked with a deadline
+ *   before the timestamp (armed from a past start, or by another context
+ *   after the last pop) is due, not 4e9 ticks away
+ */
+uint32_t SoftwareTimer_ManagerProcess(SoftwareTimer_Manager * manager)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    uint32_t now = SoftwareTimer_Now();
+    SoftwareTimer_Entry * entry;
+#ifdef SOFTWARETIMER_STATS
+    bool dispatched = false;
+#endif
+
+    while ((entry = SoftwareTimer_ManagerPopExpired(manager, now)) != NULL) {
+        entry->callback(entry);
+#ifdef SOFTWARETIMER_STATS
+        dispatched = true;
+#endif
+    }
+
+#ifdef SOFTWARETIMER_STATS
+    uint32_t elapsed = dispatched ? SoftwareTimer_Now() - now : 0;
+#endif
+
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+#ifdef SOFTWARETIMER_STATS
+    if (dispatched && manager->stats.dispatchBudget != 0 && elapsed > manager->stats.dispatchBudget)
+        SOFTWARETIMER_STATS_ADD(manager->stats.overruns, 1u);
+#endif
+    if (manager->head == NULL) {
+        SOFTWARETIMER_CRITICAL_EXIT(critical);
+        return SOFTWARETIMER_NO_DEADLINE;
+    }
+    int32_t remaining = (int32_t) (entry_deadline(manager->head) - now);
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+    return remaining > 0 ? (uint32_t) remaining : 0;
+}
+
+/**
+ * Computes remaining time of the head entry with the same signed distance
+ * as SoftwareTimer_ManagerProcess().
+ */
+uint32_t SoftwareTimer_ManagerNextDeadline(const SoftwareTimer_Manager * manager)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+    if (manager->head == NULL) {
+        SOFTWARETIMER_CRITICAL_EXIT(critical);
+        return SOFTWARETIMER_NO_DEADLINE;
+    }
+    uint32_t deadline = entry_deadline(manager->head);
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+
+    int32_t remaining = (int32_t) (deadline - SoftwareTimer_Now());
+    return remaining > 0 ? (uint32_t) remaining : 0;
+}
+
+/**
+ * Returns the first entry after the last reported one of an interrupted
+ * walk: the first with a distance above @p distance, or with the same
+ * distance after @p ties such entries. Called in the critical section.
+ */
+static const SoftwareTimer_Entry * visit_resume(const SoftwareTimer_Manager * manager, uint32_t now, int32_t distance, uint32_t ties)
+{
+    const SoftwareTimer_Entry * entry = manager->head;
+
+    while (entry != NULL) {
+        int32_t current = (int32_t) (entry_deadline(entry) - now);
+        if (current > distance || (current == distance && ties-- == 0))
+            break;
+        entry = entry->next;
+    }
+    return entry;
+}
+
+/**
+ * Walks the sorted list from the head in batches.
+ *
+ * Implementation:
+ * - The signed distance to the deadline gives the remaining time of
+ *   pending entries and the lateness of due ones
+ * - Reports of up to SOFTWARETIMER_VISIT_BATCH entries are copied inside
+ *   the critical section, which is released before the visitor runs
+ * - The next entry to copy is still linked if the list generation did not
+ *   change in between; otherwise the walk resumes by distance. Entries
+ *   with equal deadlines keep their order, so counting the reported ones
+ *   with the last distance (ties) resumes inside a run of equal deadlines
+ */
+uint32_t SoftwareTimer_ManagerVisit(const SoftwareTimer_Manager * manager, SoftwareTimer_Visitor visitor, void * context)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(visitor != NULL);
+    uint32_t now = SoftwareTimer_Now();
+    SoftwareTimer_EntryInfo batch[SOFTWARETIMER_VISIT_BATCH];
+    int32_t distances[SOFTWARETIMER_VISIT_BATCH];
+    const SoftwareTimer_Entry * next = NULL;
+    uint32_t generation = 0;
+    int32_t lastDistance = 0;
+    uint32_t ties = 0;
+    uint32_t visited = 0;
+
+    do {
+        uint32_t count = 0;
+        uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+        if (visited == 0)
+            next = manager->head;
+        else if (manager->generation != generation)
+            next = visit_resume(manager, now, lastDistance, ties);
+        for (; next != NULL && count < SOFTWARETIMER_VISIT_BATCH; next = next->next, count++) {
+            SoftwareTimer_EntryInfo * info = &batch[count];
+            int32_t distance = (int32_t) (entry_deadline(next) - now);
+
+            distances[count] = distance;
+            info->entry = next;
+            info->remaining = distance > 0 ? (uint32_t) distance : 0;
+            info->lateness = distance < 0 ? 0u - (uint32_t) distance : 0;
+            info->period = next->period;
+#ifdef SOFTWARETIMER_STATS
+            info->tag = next->tag;
+#else
+            info->tag = NULL;
+#endif
+        }
+        generation = manager->generation;
+        SOFTWARETIMER_CRITICAL_EXIT(critical);
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (visited == 0 || distances[i] != lastDistance) {
+                lastDistance = distances[i];
+                ties = 0;
+            }
+            ties++;
+            visited++;
+            if (!visitor(&batch[i], context))
+                return visited;
+        }
+    } while (next != NULL);
+    return visited;
+}
+
+#ifdef SOFTWARETIMER_STATS
+/**
+ * Stores the owner tag.
+ */
+void SoftwareTimer_EntrySetTag(SoftwareTimer_Entry * entry, const char * tag)
+{
+    SOFTWARETIMER_ASSERT(entry != NULL);
+    entry->tag = tag;
+}
+
+/**
+ * Stores the budget checked at the end of SoftwareTimer_ManagerProcess().
+ */
+void SoftwareTimer_ManagerSetBudget(SoftwareTimer_Manager * manager, uint32_t budget)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+
+    manager->stats.dispatchBudget = budget;
+    SOFTWARETIMER_CRITICAL_EXIT(critical);
+}
+#endif
+
+/** @} */
@@ -0,0 +1,286 @@
+/**
+ * @file software_timer_metrics.c
+ * @brief Metrics exporter implementation
+ * @author Richard Kubíček
+ *
+ * Both formatters append to the buffer through one writer that keeps
+ * counting after the buffer is full, which gives snprintf-like return values
+ * without a second formatting pass.
+ *
+ * Compiled only when SOFTWARETIMER_STATS is defined.
+ *
+ * @see software_timer_metrics.h for API documentation
+ */
+
+#ifdef SOFTWARETIMER_STATS
+
+    #include "software_timer_metrics.h"
+    #include "software_timer_private.h"
+    #include <stdarg.h>
+    #include <stdio.h>
+
+/**
+ * @addtogroup software_timer_metrics
+ * @{
+ */
+
+/**
+ * @struct metrics_writer
+ * @brief Output position of a formatter
+ */
+typedef struct {
+    char * buffer; /**< Output buffer */
+    size_t size; /**< Size of the output buffer */
+    size_t length; /**< Length of the complete output so far */
+} metrics_writer;
+
+/**
+ * Appends formatted text. Once the buffer is full only the length grows.
+ */
+static void writer_append(metrics_writer * writer, const char * format, ...)
+{
+    size_t room = writer->length < writer->size ? writer->size - writer->length : 0;
+    va_list args;
+
+    va_start(args, format);
+    int written = vsnprintf(room > 0 ? writer->buffer + writer->length : NULL, room, format, args);
+    va_end(args);
+    if (written > 0)
+        writer->length += (size_t) written;
+}
+
+/**
+ * Appends one character; like writer_append() it keeps the buffer
+ * NUL-terminated and only counts once the buffer is full.
+ */
+static void writer_putc(metrics_writer * writer, char c)
+{
+    if (writer->length + 1u < writer->size) {
+        writer->buffer[writer->length] = c;
+        writer->buffer[writer->length + 1u] = '\0';
+    }
+    writer->length++;
+}
+
+/**
+ * @enum metrics_escape
+ * @brief Escaping rules of the output formats
+ */
+typedef enum {
+    ESCAPE_PROMETHEUS, /**< Label value: backslash, double quote and newline */
+    ESCAPE_JSON, /**< JSON string: backslash, double quote and control characters */
+    ESCAPE_TEXT /**< Table cell: backslash and newline, so each row stays one line */
+} metrics_escape;
+
+/**
+ * Appends @p text with the characters special to @p escape escaped.
+ */
+static void writer_append_escaped(metrics_writer * writer, const char * text, metrics_escape escape)
+{
+    for (; *text != '\0'; text++) {
+        unsigned char c = (unsigned char) *text;
+
+        if (c == '\\' || (c == '"' && escape != ESCAPE_TEXT)) {
+            writer_putc(writer, '\\');
+            writer_putc(writer, (char) c);
+        } else if (c == '\n') {
+            writer_putc(writer, '\\');
+            writer_putc(writer, 'n');
+        } else if (c < 0x20u && escape == ESCAPE_JSON) {
+            writer_append(writer, "\\u%04x", (unsigned) c);
+        } else {
+            writer_putc(writer, (char) c);
+        }
+    }
+}
+
+/**
+ * Appends one Prometheus sample with the engine label and an optional le
+ * label.
+ */
+static void writer_append_sample(metrics_writer * writer, const char * name, const char * engine, const char * le, unsigned long value)
+{
+    writer_append(writer, "%s{engine=\"", name);
+    writer_append_escaped(writer, engine, ESCAPE_PROMETHEUS);
+    if (le != NULL)
+        writer_append(writer, "\",le=\"%s", le);
+    writer_append(writer, "\"} %lu\n", value);
+}
+
+/**
+ * Returns the largest lateness counted by histogram bucket @p bucket, or
+ * SOFTWARETIMER_METRICS_OVERFLOW for the last bucket.
+ */
+static uint32_t bucket_upper_bound(uint32_t bucket)
+{
+    if (bucket >= SOFTWARETIMER_STATS_BUCKETS - 1u)
+        return SOFTWARETIMER_METRICS_OVERFLOW;
+    return (1u << bucket) - 1u;
+}
+
+/**
+ * Copies the manager counters and the core clock read counter with relaxed
+ * atomic loads, without entering the manager's critical section.
+ */
+void SoftwareTimer_MetricsSnapshot(const SoftwareTimer_Manager * manager, SoftwareTimer_Metrics * metrics)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(metrics != NULL);
+
+    metrics->active = SOFTWARETIMER_STATS_LOAD(manager->stats.active);
+    metrics->expirations = SOFTWARETIMER_STATS_LOAD(manager->stats.expirations);
+    metrics->overruns = SOFTWARETIMER_STATS_LOAD(manager->stats.overruns);
+    metrics->clockReads = SoftwareTimer_ClockReads();
+    metrics->latenessSum = SOFTWARETIMER_STATS_LOAD(manager->stats.latenessSum);
+    for (uint32_t i = 0; i < SOFTWARETIMER_STATS_BUCKETS; i++) {
+        metrics->lateness[i] = SOFTWARETIMER_STATS_LOAD(manager->stats.lateness[i]);
+    }
+}
+
+/**
+ * Walks the cumulative histogram up to the rank of the percentile
+ * (nearest-rank method).
+ */
+uint32_t SoftwareTimer_MetricsLatenessPercentile(const SoftwareTimer_Metrics * metrics, uint32_t percent)
+{
+    SOFTWARETIMER_ASSERT(metrics != NULL);
+    SOFTWARETIMER_ASSERT(percent >= 1 && percent <= 100);
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < SOFTWARETIMER_STATS_BUCKETS; i++) {
+        total += metrics->lateness[i];
+    }
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = (total * percent + 99u) / 100u;
+    uint64_t cumulative = 0;
+    for (uint32_t i = 0; i < SOFTWARETIMER_STATS_BUCKETS; i++) {
+        cumulative += metrics->lateness[i];
+        if (cumulative >= rank)
+            return bucket_upper_bound(i);
+    }
+    return SOFTWARETIMER_METRICS_OVERFLOW;
+}
+
+/**
+ * Writes gauges and counters followed by the lateness histogram with
+ * cumulative buckets, as required by the exposition format.
+ */
+int SoftwareTimer_MetricsFormatPrometheus(const SoftwareTimer_Metrics * metrics, const char * engine, char * buffer, size_t size)
+{
+    SOFTWARETIMER_ASSERT(metrics != NULL);
+    SOFTWARETIMER_ASSERT(engine != NULL);
+    SOFTWARETIMER_ASSERT(buffer != NULL || size == 0);
+    metrics_writer writer = {buffer, size, 0};
+    unsigned long cumulative = 0;
+
+    if (size > 0)
+        buffer[0] = '\0';
+
+    writer_append(&writer, "# HELP softwaretimer_active_timers Armed timer entries.\n# TYPE softwaretimer_active_timers gauge\n");
+    writer_append_sample(&writer, "softwaretimer_active_timers", engine, NULL, (unsigned long) metrics->active);
+    writer_append(&writer, "# HELP softwaretimer_expirations_total Expired timer entries.\n# TYPE softwaretimer_expirations_total counter\n");
+    writer_append_sample(&writer, "softwaretimer_expirations_total", engine, NULL, (unsigned long) metrics->expirations);
+    writer_append(&writer, "# HELP softwaretimer_dispatch_overruns_total Dispatch calls exceeding their budget.\n# TYPE softwaretimer_dispatch_overruns_total counter\n");
+    writer_append_sample(&writer, "softwaretimer_dispatch_overruns_total", engine, NULL, (unsigned long) metrics->overruns);
+    writer_append(&writer, "# HELP softwaretimer_clock_reads_total Clock source reads.\n# TYPE softwaretimer_clock_reads_total counter\n");
+    writer_append_sample(&writer, "softwaretimer_clock_reads_total", engine, NULL, (unsigned long) metrics->clockReads);
+
+    writer_append(&writer, "# HELP softwaretimer_lateness_ticks Delay between deadline and dispatch.\n# TYPE softwaretimer_lateness_ticks histogram\n");
+    for (uint32_t i = 0; i < SOFTWARETIMER_STATS_BUCKETS; i++) {
+        char le[12];
+
+        cumulative += metrics->lateness[i];
+        if (i < SOFTWARETIMER_STATS_BUCKETS - 1u)
+            snprintf(le, sizeof(le), "%lu", (unsigned long) bucket_upper_bound(i));
+        else
+            snprintf(le, sizeof(le), "+Inf");
+        writer_append_sample(&writer, "softwaretimer_lateness_ticks_bucket", engine, le, cumulative);
+    }
+    writer_append_sample(&writer, "softwaretimer_lateness_ticks_sum", engine, NULL, (unsigned long) metrics->latenessSum);
+    writer_append_sample(&writer, "softwaretimer_lateness_ticks_count", engine, NULL, cumulative);
+
+    return (int) writer.length;
+}
+
+/**
+ * Appends a percentile as a number, or null for the unbounded bucket.
+ */
+static void writer_append_percentile(metrics_writer * writer, const char * name, uint32_t value)
+{
+    if (value == SOFTWARETIMER_METRICS_OVERFLOW)
+        writer_append(writer, ",\"%s\":null", name);
+    else
+        writer_append(writer, ",\"%s\":%lu", name, (unsigned long) value);
+}
+
+/**
+ * Writes a single-line JSON object with the counters, the raw histogram
+ * and percentile estimates.
+ */
+int SoftwareTimer_MetricsFormatJson(const SoftwareTimer_Metrics * metrics, const char * engine, char * buffer, size_t size)
+{
+    SOFTWARETIMER_ASSERT(metrics != NULL);
+    SOFTWARETIMER_ASSERT(engine != NULL);
+    SOFTWARETIMER_ASSERT(buffer != NULL || size == 0);
+    metrics_writer writer = {buffer, size, 0};
+
+    if (size > 0)
+        buffer[0] = '\0';
+
+    writer_append(&writer, "{\"engine\":\"");
+    writer_append_escaped(&writer, engine, ESCAPE_JSON);
+    writer_append(&writer, "\",\"active\":%lu,\"expirations\":%lu,\"overruns\":%lu,\"clockReads\":%lu,", (unsigned long) metrics->active,
+                  (unsigned long) metrics->expirations, (unsigned long) metrics->overruns, (unsigned long) metrics->clockReads);
+    writer_append(&writer, "\"lateness\":{\"sum\":%lu,\"buckets\":[", (unsigned long) metrics->latenessSum);
+    for (uint32_t i = 0; i < SOFTWARETIMER_STATS_BUCKETS; i++) {
+        writer_append(&writer, i == 0 ? "%lu" : ",%lu", (unsigned long) metrics->lateness[i]);
+    }
+    writer_append(&writer, "]");
+    writer_append_percentile(&writer, "p50", SoftwareTimer_MetricsLatenessPercentile(metrics, 50));
+    writer_append_percentile(&writer, "p90", SoftwareTimer_MetricsLatenessPercentile(metrics, 90));
+    writer_append_percentile(&writer, "p99", SoftwareTimer_MetricsLatenessPercentile(metrics, 99));
+    writer_append(&writer, "}}");
+
+    return (int) writer.length;
+}
+
+/**
+ * Visitor of SoftwareTimer_MetricsFormatDump(): appends one table row.
+ */
+static bool dump_entry(const SoftwareTimer_EntryInfo * info, void * context)
+{
+    metrics_writer * writer = (metrics_writer *) context;
+
+    writer_append(writer, "%10lu %10lu %10lu ", (unsigned long) info->remaining, (unsigned long) info->lateness, (unsigned long) info->period);
+    writer_append_escaped(writer, info->tag != NULL ? info->tag : "-", ESCAPE_TEXT);
+    writer_putc(writer, '\n');
+    return true;
+}
+
+/**
+ * Writes the header and lets the manager walk its list into the writer.
+ */
+int SoftwareTimer_MetricsFormatDump(const SoftwareTimer_Manager * manager, char * buffer, size_t size)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(buffer != NULL || size == 0);
+    metrics_writer writer = {buffer, size, 0};
+
+    if (size > 0)
+        buffer[0] = '\0';
+
+    writer_append(&writer, "%10s %10s %10s %s\n", "remaining", "late", "period", "tag");
+    SoftwareTimer_ManagerVisit(manager, dump_entry, &writer);
+    return (int) writer.length;
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_metrics_disabled;
+
+#endif // SOFTWARETIMER_STATS
@@ -0,0 +1,150 @@
+/**
+ * @file software_timer_pll.c
+ * @brief Phase-locked periodic timer implementation
+ * @author Richard Kubíček
+ *
+ * The expiration grid is next + fraction / 65536 + k * period. A sync pulse
+ * is compared with the nearest grid point; the difference is the phase
+ * error, positive when the reference is later than the timer.
+ *
+ * @see software_timer_pll.h for API documentation
+ */
+
+#include "software_timer_pll.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_pll
+ * @{
+ */
+
+/**
+ * @def PLL_ONE
+ * @brief One tick in Q16.16
+ */
+#define PLL_ONE 65536
+
+/**
+ * Returns the corrected period in Q16.16 ticks.
+ */
+static int64_t pll_period(const SoftwareTimer_Pll * pll)
+{
+    return (int64_t) pll->nominal + pll->correction;
+}
+
+/**
+ * Moves the expiration grid by @p delta Q16.16 ticks in either direction.
+ * The whole ticks are rounded towards minus infinity so that the fraction
+ * stays in [0, 1).
+ */
+static void pll_move(SoftwareTimer_Pll * pll, int64_t delta)
+{
+    int64_t position = (int64_t) pll->fraction + delta;
+    int64_t whole = position >= 0 ? position / PLL_ONE : -((-position + PLL_ONE - 1) / PLL_ONE);
+
+    pll->next += (uint32_t) whole;
+    pll->fraction = (uint32_t) (position - whole * PLL_ONE);
+}
+
+/**
+ * Places the first expiration one period from now.
+ */
+void SoftwareTimer_PllInit(SoftwareTimer_Pll * pll, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(pll != NULL);
+    SOFTWARETIMER_ASSERT(period >= PLL_ONE && period < (32768u << 16));
+
+    pll->next = SoftwareTimer_Now();
+    pll->fraction = 0;
+    pll->nominal = period;
+    pll->correction = 0;
+    pll->error = 0;
+    pll->lastSync = 0;
+    pll->synced = false;
+    pll_move(pll, period);
+}
+
+/**
+ * Runs one step of the proportional-integral loop.
+ *
+ * Implementation:
+ * - The phase error is the pulse time relative to the next expiration,
+ *   reduced modulo the period into [-period/2, period/2)
+ * - The period correction grows by the error divided by the number of
+ *   periods since the previous pulse (the drift per period), scaled by the
+ *   integral gain and limited to 1/8 of the nominal period
+ * - The grid is then moved by the error scaled by the proportional gain;
+ *   the first pulse moves it by the whole error
+ */
+void SoftwareTimer_PllSync(SoftwareTimer_Pll * pll, uint32_t timestamp)
+{
+    SOFTWARETIMER_ASSERT(pll != NULL);
+    int64_t period = pll_period(pll);
+    int64_t error = ((int64_t) (int32_t) (timestamp - pll->next) * PLL_ONE - (int64_t) pll->fraction) % period;
+
+    if (error >= period / 2)
+        error -= period;
+    else if (error < -period / 2)
+        error += period;
+    pll->error = (int32_t) error;
+
+    if (!pll->synced) {
+        pll->synced = true;
+        pll_move(pll, error);
+    } else {
+        int64_t periods = ((int64_t) (timestamp - pll->lastSync) * PLL_ONE + period / 2) / period;
+        if (periods > 0) {
+            int64_t limit = (int64_t) (pll->nominal / 8u);
+            int64_t correction = pll->correction + error / periods / (1 << SOFTWARETIMER_PLL_FREQUENCY_SHIFT);
+            if (correction > limit)
+                correction = limit;
+            else if (correction < -limit)
+                correction = -limit;
+            pll->correction = (int32_t) correction;
+        }
+        pll_move(pll, error / (1 << SOFTWARETIMER_PLL_PHASE_SHIFT));
+    }
+    pll->lastSync = timestamp;
+}
+
+/**
+ * Advances the grid by one corrected period when the next expiration is due.
+ * A grid point with a fraction is due on the following whole tick, never
+ * before it.
+ */
+bool SoftwareTimer_PllIsExpired(SoftwareTimer_Pll * pll)
+{
+    SOFTWARETIMER_ASSERT(pll != NULL);
+    int32_t elapsed = (int32_t) (SoftwareTimer_Now() - pll->next);
+
+    if (elapsed < 0 || (elapsed == 0 && pll->fraction != 0))
+        return false;
+    pll_move(pll, pll_period(pll));
+    return true;
+}
+
+/**
+ * Signed difference between the tick the next expiration is due on and now,
+ * clamped at 0.
+ */
+uint32_t SoftwareTimer_PllRemaining(const SoftwareTimer_Pll * pll)
+{
+    SOFTWARETIMER_ASSERT(pll != NULL);
+    int32_t remaining = (int32_t) (pll->next - SoftwareTimer_Now());
+
+    if (remaining < 0)
+        return 0;
+    return (uint32_t) remaining + (pll->fraction != 0 ? 1u : 0u);
+}
+
+/**
+ * Compares the magnitude of the last phase error with one tick.
+ */
+bool SoftwareTimer_PllIsLocked(const SoftwareTimer_Pll * pll)
+{
+    SOFTWARETIMER_ASSERT(pll != NULL);
+    return pll->synced && pll->error <= PLL_ONE && pll->error >= -PLL_ONE;
+}
+
+/** @} */
@@ -0,0 +1,228 @@
+/**
+ * @file software_timer_posix.c
+ * @brief Hosted (POSIX) helpers implementation
+ * @author Richard Kubíček
+ *
+ * Compiled only on POSIX systems; on other targets this translation unit is
+ * empty.
+ *
+ * @see software_timer_posix.h for API documentation
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    #if defined(__linux__) && !defined(_GNU_SOURCE)
+        #define _GNU_SOURCE // ppoll
+    #endif
+
+    #include "software_timer_posix.h"
+    #include "software_timer_private.h"
+    #include <errno.h>
+    #include <limits.h>
+    #include <stddef.h>
+    #include <string.h>
+    #ifdef __linux__
+        #include <sys/timerfd.h>
+    #endif
+
+/**
+ * @addtogroup software_timer_posix
+ * @{
+ */
+
+/**
+ * Returns the nanoseconds of a fraction of a second given in ticks, rounded
+ * up so that a timeout built from it never ends before the tick. The result
+ * stays below one second for tick rates up to 10^9.
+ */
+static long ticks_to_ns(uint32_t ticks)
+{
+    return (long) (((uint64_t) ticks * 1000000000u + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ);
+}
+
+/**
+ * Splits the remaining ticks into seconds and nanoseconds. The 64-bit
+ * intermediate keeps the conversion exact for any tick rate; a fraction of
+ * a nanosecond is rounded up, as in the millisecond @c poll fallback.
+ */
+void SoftwareTimer_ToTimespec(const SoftwareTimer * timer, struct timespec * timeout)
+{
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    SOFTWARETIMER_ASSERT(timeout != NULL);
+    uint32_t remaining = SoftwareTimer_Remaining(timer);
+
+    timeout->tv_sec = (time_t) (remaining / SOFTWARETIMER_TICK_HZ);
+    timeout->tv_nsec = ticks_to_ns(remaining % SOFTWARETIMER_TICK_HZ);
+}
+
+/**
+ * Waits with the remaining time of the timer and retries after EINTR.
+ *
+ * Implementation:
+ * - The timeout is recomputed from the timer on every iteration, so the
+ *   total wait is bounded by the timer deadline and does not drift
+ * - An expired timer still performs one non-blocking poll so that ready
+ *   descriptors are reported
+ */
+int SoftwareTimer_Poll(struct pollfd * fds, nfds_t nfds, const SoftwareTimer * timer)
+{
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    int result;
+
+    do {
+    #ifdef __linux__
+        struct timespec timeout;
+        SoftwareTimer_ToTimespec(timer, &timeout);
+        result = ppoll(fds, nfds, &timeout, NULL);
+    #else
+        uint64_t milliseconds = ((uint64_t) SoftwareTimer_Remaining(timer) * 1000u + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ;
+        result = poll(fds, nfds, milliseconds > INT_MAX ? INT_MAX : (int) milliseconds);
+    #endif
+    } while (result < 0 && errno == EINTR);
+
+    return result;
+}
+
+/**
+ * Adds the next-deadline query result to the current monotonic time.
+ */
+bool SoftwareTimer_ManagerNextTimespec(const SoftwareTimer_Manager * manager, struct timespec * deadline)
+{
+    SOFTWARETIMER_ASSERT(manager != NULL);
+    SOFTWARETIMER_ASSERT(deadline != NULL);
+    uint32_t remaining = SoftwareTimer_ManagerNextDeadline(manager);
+
+    if (remaining == SOFTWARETIMER_NO_DEADLINE)
+        return false;
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += (time_t) (remaining / SOFTWARETIMER_TICK_HZ);
+    deadline->tv_nsec += ticks_to_ns(remaining % SOFTWARETIMER_TICK_HZ);
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    return true;
+}
+
+    #ifdef __linux__
+/**
+ * Arms the timerfd with an absolute deadline, or disarms it with a zero
+ * it_value when no entry is armed. An armed entry's deadline is the current
+ * monotonic time or later, never zero, and a deadline already passed makes
+ * the absolute timerfd readable immediately.
+ */
+int SoftwareTimer_TimerfdArm(int fd, const SoftwareTimer_Manager * manager)
+{
+    struct itimerspec spec = {0};
+
+    SoftwareTimer_ManagerNextTimespec(manager, &spec.it_value);
+    return timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+    #endif
+
+/**
+ * Reads CLOCK_MONOTONIC in nanoseconds.
+ */
+static int64_t monotonic_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * Sleeps until an absolute CLOCK_MONOTONIC time, restarting after signals.
+ * Where clock_nanosleep is not available, the remaining time is recomputed
+ * for nanosleep on every iteration.
+ */
+static void sleep_until_ns(int64_t target)
+{
+    #ifdef __linux__
+    struct timespec wake = {.tv_sec = (time_t) (target / 1000000000), .tv_nsec = (long) (target % 1000000000)};
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) {
+    }
+    #else
+    int64_t remaining;
+
+    while ((remaining = target - monotonic_ns()) > 0) {
+        struct timespec wait = {.tv_sec = (time_t) (remaining / 1000000000), .tv_nsec = (long) (remaining % 1000000000)};
+        nanosleep(&wait, NULL);
+    }
+    #endif
+}
+
+/**
+ * Folds one wake latency sample into the estimate.
+ *
+ * Implementation:
+ * - Jacobson/Karels smoothing: latency += sample - latency / 8 and
+ *   deviation += |error| - deviation / 4, both kept scaled to stay integer
+ * - Samples are capped at the maximum margin, which bounds the scaled
+ *   values well below UINT32_MAX
+ */
+static void sleeper_update(SoftwareTimer_Sleeper * sleeper, int64_t sample)
+{
+    if (sample < 0)
+        sample = 0;
+    if (sample > SOFTWARETIMER_SLEEP_MAX_MARGIN_NS)
+        sample = SOFTWARETIMER_SLEEP_MAX_MARGIN_NS;
+
+    int64_t error = sample - (int64_t) (sleeper->latency >> 3);
+    sleeper->latency = (uint32_t) ((int64_t) sleeper->latency + error);
+    if (error < 0)
+        error = -error;
+    sleeper->deviation = (uint32_t) ((int64_t) sleeper->deviation + error - (int64_t) (sleeper->deviation >> 2));
+
+    uint32_t margin = (sleeper->latency >> 3) + sleeper->deviation;
+    sleeper->margin = margin > SOFTWARETIMER_SLEEP_MAX_MARGIN_NS ? SOFTWARETIMER_SLEEP_MAX_MARGIN_NS : margin;
+}
+
+/**
+ * Clears the estimate; the first sleep runs without margin.
+ */
+void SoftwareTimer_SleeperInit(SoftwareTimer_Sleeper * sleeper)
+{
+    SOFTWARETIMER_ASSERT(sleeper != NULL);
+    memset(sleeper, 0, sizeof(*sleeper));
+}
+
+/**
+ * Sleeps to the deadline minus the margin, calibrates and spins the rest.
+ *
+ * Implementation:
+ * - No sleep (and no sample) when the deadline is closer than the margin
+ * - The tick to nanosecond conversion rounds up, so the spin never ends
+ *   before the timer's deadline
+ */
+void SoftwareTimer_SleepUntil(SoftwareTimer_Sleeper * sleeper, const SoftwareTimer * timer)
+{
+    SOFTWARETIMER_ASSERT(sleeper != NULL);
+    SOFTWARETIMER_ASSERT(timer != NULL);
+    uint32_t remaining = SoftwareTimer_Remaining(timer);
+    int64_t now = monotonic_ns();
+    int64_t deadline = now + (int64_t) (((uint64_t) remaining * 1000000000u + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ);
+    int64_t target = deadline - sleeper->margin;
+
+    if (target > now) {
+        sleep_until_ns(target);
+        now = monotonic_ns();
+        sleeper_update(sleeper, now - target);
+        if (now > deadline)
+            sleeper->lateWakes++;
+    }
+    while (now < deadline) {
+        now = monotonic_ns();
+    }
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_posix_disabled;
+
+#endif // defined(__unix__) || defined(__APPLE__)
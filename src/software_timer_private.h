@@ -0,0 +1,178 @@
+/**
+ * @file software_timer_private.h
+ * @brief Internal definitions shared by the SoftwareTimer library sources
+ * @author Richard Kubíček
+ *
+ * This header is not part of the public API. It collects configuration
+ * defaults that every translation unit of the library needs.
+ */
+
+#ifndef SOFTWARE_TIMER_PRIVATE_H
+#define SOFTWARE_TIMER_PRIVATE_H
+
+/**
+ * @def SOFTWARETIMER_ASSERT
+ * @brief Configurable assertion macro for parameter validation
+ *
+ * Users can define their own assertion handler by defining SOFTWARETIMER_ASSERT
+ * before including this file. If not defined, the default behavior is:
+ * - In debug builds (NDEBUG not defined): use standard assert()
+ * - In release builds (NDEBUG defined): compile to empty statement
+ *
+ * Example of custom assertion:
+ * @code
+ * #define SOFTWARETIMER_ASSERT(expr) if(!(expr)) my_error_handler()
+ * #include "software_timer.c"
+ * @endcode
+ */
+#ifndef SOFTWARETIMER_ASSERT
+    #ifdef NDEBUG
+        #define SOFTWARETIMER_ASSERT(expr) ((void) 0)
+    #else
+        #include <assert.h>
+        #define SOFTWARETIMER_ASSERT(expr) assert(expr)
+    #endif
+#endif
+
+/**
+ * @def SOFTWARETIMER_CRITICAL_NONE
+ * @brief Critical-section strategy: no protection, single execution context
+ */
+#define SOFTWARETIMER_CRITICAL_NONE 0
+
+/**
+ * @def SOFTWARETIMER_CRITICAL_IRQ
+ * @brief Critical-section strategy: disable and restore interrupts
+ */
+#define SOFTWARETIMER_CRITICAL_IRQ 1
+
+/**
+ * @def SOFTWARETIMER_CRITICAL_SPINLOCK
+ * @brief Critical-section strategy: spinlock shared by several cores
+ */
+#define SOFTWARETIMER_CRITICAL_SPINLOCK 2
+
+/**
+ * @def SOFTWARETIMER_CRITICAL_PTHREAD
+ * @brief Critical-section strategy: pthread mutex
+ */
+#define SOFTWARETIMER_CRITICAL_PTHREAD 3
+
+/**
+ * @def SOFTWARETIMER_CRITICAL
+ * @brief Critical-section strategy protecting manager state
+ *
+ * One of the SOFTWARETIMER_CRITICAL_* values, selected at compile time for
+ * the whole build. Defaults to @ref SOFTWARETIMER_CRITICAL_NONE. See
+ * software_timer_config_template.h for the hooks of each strategy.
+ */
+#ifndef SOFTWARETIMER_CRITICAL
+    #define SOFTWARETIMER_CRITICAL SOFTWARETIMER_CRITICAL_NONE
+#endif
+
+/**
+ * @def SOFTWARETIMER_CRITICAL_ENTER
+ * @brief Enters the critical section, evaluates to a uint32_t state
+ *
+ * @def SOFTWARETIMER_CRITICAL_EXIT
+ * @brief Leaves the critical section entered with the given state
+ *
+ * Critical sections must not nest and must not call user callbacks. Used as:
+ * @code
+ * uint32_t critical = SOFTWARETIMER_CRITICAL_ENTER();
+ * // access shared state
+ * SOFTWARETIMER_CRITICAL_EXIT(critical);
+ * @endcode
+ */
+#if SOFTWARETIMER_CRITICAL == SOFTWARETIMER_CRITICAL_NONE
+    #define SOFTWARETIMER_CRITICAL_ENTER() 0u
+    #define SOFTWARETIMER_CRITICAL_EXIT(state) ((void) (state))
+#elif SOFTWARETIMER_CRITICAL == SOFTWARETIMER_CRITICAL_IRQ
+    #if !defined(SOFTWARETIMER_IRQ_DISABLE) && defined(__GNUC__) && defined(__ARM_ARCH) && !defined(__ARM_ARCH_ISA_A64) && defined(__ARM_ARCH_PROFILE) && \
+        __ARM_ARCH_PROFILE == 'M'
+        #include <stdint.h>
+static inline uint32_t softwaretimer_irq_disable(void)
+{
+    uint32_t primask;
+    __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask)::"memory");
+    return primask;
+}
+
+static inline void softwaretimer_irq_restore(uint32_t primask)
+{
+    __asm volatile("msr primask, %0" ::"r"(primask) : "memory");
+}
+        #define SOFTWARETIMER_IRQ_DISABLE() softwaretimer_irq_disable()
+        #define SOFTWARETIMER_IRQ_RESTORE(state) softwaretimer_irq_restore(state)
+    #endif
+    #if !defined(SOFTWARETIMER_IRQ_DISABLE) || !defined(SOFTWARETIMER_IRQ_RESTORE)
+        #error "SOFTWARETIMER_CRITICAL_IRQ needs SOFTWARETIMER_IRQ_DISABLE() and SOFTWARETIMER_IRQ_RESTORE(state) on this target"
+    #endif
+    #define SOFTWARETIMER_CRITICAL_ENTER() ((uint32_t) SOFTWARETIMER_IRQ_DISABLE())
+    #define SOFTWARETIMER_CRITICAL_EXIT(state) SOFTWARETIMER_IRQ_RESTORE(state)
+#elif SOFTWARETIMER_CRITICAL == SOFTWARETIMER_CRITICAL_SPINLOCK
+    #if !defined(SOFTWARETIMER_SPIN_LOCK) || !defined(SOFTWARETIMER_SPIN_UNLOCK)
+        #if !defined(__GNUC__)
+            #error "SOFTWARETIMER_CRITICAL_SPINLOCK needs SOFTWARETIMER_SPIN_LOCK() and SOFTWARETIMER_SPIN_UNLOCK(state) on this compiler"
+        #endif
+        #include <stdint.h>
+extern volatile uint32_t softwaretimer_spinlock;
+
+static inline uint32_t softwaretimer_spin_lock(void)
+{
+    while (__atomic_exchange_n(&softwaretimer_spinlock, 1u, __ATOMIC_ACQUIRE) != 0u) {
+    }
+    return 0;
+}
+
+static inline void softwaretimer_spin_unlock(uint32_t state)
+{
+    (void) state;
+    __atomic_store_n(&softwaretimer_spinlock, 0u, __ATOMIC_RELEASE);
+}
+        #define SOFTWARETIMER_SPIN_LOCK() softwaretimer_spin_lock()
+        #define SOFTWARETIMER_SPIN_UNLOCK(state) softwaretimer_spin_unlock(state)
+        #define SOFTWARETIMER_SPINLOCK_STORAGE
+    #endif
+    #define SOFTWARETIMER_CRITICAL_ENTER() ((uint32_t) SOFTWARETIMER_SPIN_LOCK())
+    #define SOFTWARETIMER_CRITICAL_EXIT(state) SOFTWARETIMER_SPIN_UNLOCK(state)
+#elif SOFTWARETIMER_CRITICAL == SOFTWARETIMER_CRITICAL_PTHREAD
+    #include <pthread.h>
+extern pthread_mutex_t softwaretimer_mutex;
+    #define SOFTWARETIMER_CRITICAL_ENTER() ((uint32_t) pthread_mutex_lock(&softwaretimer_mutex))
+    #define SOFTWARETIMER_CRITICAL_EXIT(state) ((void) (state), (void) pthread_mutex_unlock(&softwaretimer_mutex))
+#else
+    #error "Unknown SOFTWARETIMER_CRITICAL strategy"
+#endif
+
+/**
+ * @def SOFTWARETIMER_STATS_LOAD
+ * @brief Reads a uint32_t statistics counter of a manager
+ *
+ * @def SOFTWARETIMER_STATS_ADD
+ * @brief Adds to a uint32_t statistics counter of a manager
+ *
+ * @def SOFTWARETIMER_STATS_SUB
+ * @brief Subtracts from a uint32_t statistics counter of a manager
+ *
+ * Counters have one writer at a time (the owning context, or whoever holds
+ * the critical section) and are read by snapshots from any context without
+ * locking. Both macros are therefore plain relaxed atomic loads and stores,
+ * not read-modify-write operations, and cost the same as ordinary accesses
+ * on the hot path. Compilers without the @c __atomic builtins fall back to
+ * volatile accesses, which are single-copy atomic for aligned 32-bit words
+ * on the supported targets.
+ */
+#ifdef SOFTWARETIMER_STATS
+    #if defined(__GNUC__)
+        #define SOFTWARETIMER_STATS_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+        #define SOFTWARETIMER_STATS_STORE_(counter, value) __atomic_store_n(&(counter), (value), __ATOMIC_RELAXED)
+    #else
+        #define SOFTWARETIMER_STATS_LOAD(counter) (*(const volatile uint32_t *) &(counter))
+        #define SOFTWARETIMER_STATS_STORE_(counter, value) ((void) (*(volatile uint32_t *) &(counter) = (value)))
+    #endif
+    #define SOFTWARETIMER_STATS_ADD(counter, value) SOFTWARETIMER_STATS_STORE_(counter, SOFTWARETIMER_STATS_LOAD(counter) + (uint32_t) (value))
+    #define SOFTWARETIMER_STATS_SUB(counter, value) SOFTWARETIMER_STATS_STORE_(counter, SOFTWARETIMER_STATS_LOAD(counter) - (uint32_t) (value))
+#endif
+
+#endif // SOFTWARE_TIMER_PRIVATE_H
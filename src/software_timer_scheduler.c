@@ -0,0 +1,116 @@
+/**
+ * @file software_timer_scheduler.c
+ * @brief Cooperative task scheduler implementation
+ * @author Richard Kubíček
+ *
+ * Runnable tasks are kept in a FIFO ready list. Delayed tasks are kept only
+ * in the scheduler's timer manager; the wake-up callback moves them back to
+ * the ready list. A scheduler pass therefore never touches sleeping tasks.
+ *
+ * @see software_timer_scheduler.h for API documentation
+ */
+
+#include "software_timer_scheduler.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_scheduler
+ * @{
+ */
+
+/**
+ * Appends a task to the ready list.
+ */
+static void scheduler_make_ready(SoftwareTimer_Scheduler * scheduler, SoftwareTimer_Task * task)
+{
+    task->state = SOFTWARETIMER_TASK_READY;
+    task->next = NULL;
+    if (scheduler->readyTail != NULL)
+        scheduler->readyTail->next = task;
+    else
+        scheduler->readyHead = task;
+    scheduler->readyTail = task;
+}
+
+/**
+ * Wake-up entry callback of a delayed task.
+ */
+static void scheduler_wakeup(SoftwareTimer_Entry * entry)
+{
+    SoftwareTimer_Task * task = (SoftwareTimer_Task *) entry->context;
+    scheduler_make_ready(task->scheduler, task);
+}
+
+/**
+ * Clears the ready list and the manager of delayed tasks.
+ */
+void SoftwareTimer_SchedulerInit(SoftwareTimer_Scheduler * scheduler)
+{
+    SOFTWARETIMER_ASSERT(scheduler != NULL);
+    SoftwareTimer_ManagerInit(&scheduler->manager);
+    scheduler->readyHead = NULL;
+    scheduler->readyTail = NULL;
+}
+
+/**
+ * Resets the continuation point and queues the task.
+ */
+void SoftwareTimer_TaskStart(SoftwareTimer_Scheduler * scheduler, SoftwareTimer_Task * task, SoftwareTimer_TaskFunction function, void * context)
+{
+    SOFTWARETIMER_ASSERT(scheduler != NULL);
+    SOFTWARETIMER_ASSERT(task != NULL);
+    SOFTWARETIMER_ASSERT(function != NULL);
+    SoftwareTimer_EntryInit(&task->wakeup, scheduler_wakeup, task);
+    task->function = function;
+    task->context = context;
+    task->scheduler = scheduler;
+    task->resume = 0;
+    scheduler_make_ready(scheduler, task);
+}
+
+/**
+ * Arms the wake-up entry. The task is re-queued by scheduler_wakeup().
+ */
+void SoftwareTimer_TaskDelay(SoftwareTimer_Task * task, uint32_t ticks)
+{
+    SOFTWARETIMER_ASSERT(task != NULL);
+    task->state = SOFTWARETIMER_TASK_DELAYED;
+    SoftwareTimer_ManagerStart(&task->scheduler->manager, &task->wakeup, ticks);
+}
+
+/**
+ * Runs one pass over the tasks that are runnable at its start.
+ *
+ * Implementation:
+ * - Expired wake-up entries are processed first (one clock read)
+ * - The ready list is detached, so tasks queued during the pass run in the
+ *   next pass and a yielding task cannot starve the loop
+ * - After its body returns, a task that is still READY is queued again;
+ *   DELAYED tasks wait in the manager and DONE tasks are dropped
+ * - When nothing is runnable the manager's next-deadline query tells the
+ *   caller how long it may sleep
+ */
+uint32_t SoftwareTimer_SchedulerRun(SoftwareTimer_Scheduler * scheduler)
+{
+    SOFTWARETIMER_ASSERT(scheduler != NULL);
+    SoftwareTimer_ManagerProcess(&scheduler->manager);
+
+    SoftwareTimer_Task * task = scheduler->readyHead;
+    scheduler->readyHead = NULL;
+    scheduler->readyTail = NULL;
+
+    while (task != NULL) {
+        SoftwareTimer_Task * next = task->next;
+        task->function(task);
+        if (task->state == SOFTWARETIMER_TASK_READY)
+            scheduler_make_ready(scheduler, task);
+        task = next;
+    }
+
+    if (scheduler->readyHead != NULL)
+        return 0;
+    return SoftwareTimer_ManagerNextDeadline(&scheduler->manager);
+}
+
+/** @} */
@@ -0,0 +1,274 @@
+/**
+ * @file software_timer_service.c
+ * @brief Hosted timer service thread implementation
+ * @author Richard Kubíček
+ *
+ * The timer thread and the workers share one mutex. The timer thread waits
+ * on a condition variable bound to CLOCK_MONOTONIC with the absolute time of
+ * the manager's earliest deadline, so arming an earlier entry can wake it
+ * before that deadline. Callbacks always run on workers with the mutex
+ * released.
+ *
+ * Compiled only where __unix__ is defined; macOS has no
+ * pthread_condattr_setclock. On other targets this translation unit is
+ * empty.
+ *
+ * @see software_timer_service.h for API documentation
+ */
+
+#if defined(__unix__)
+
+    #if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+        #define _POSIX_C_SOURCE 200809L // pthread_condattr_setclock
+    #endif
+
+    #include "software_timer_service.h"
+    #include "software_timer_posix.h"
+    #include "software_timer_private.h"
+    #include <stddef.h>
+    #include <time.h>
+
+/**
+ * @addtogroup software_timer_service
+ * @{
+ */
+
+/**
+ * Returns true if @p entry is waiting in the queue. Called with the lock held.
+ */
+static bool service_is_queued(const SoftwareTimer_Service * service, const SoftwareTimer_Entry * entry)
+{
+    for (uint32_t i = 0; i < service->count; i++) {
+        if (service->queue[(service->head + i) % service->capacity] == entry)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Hands an expired entry to the workers. Called with the lock held by the
+ * timer thread.
+ *
+ * Implementation:
+ * - DROP counts and discards the expiration when the queue is full
+ * - COALESCE counts and discards it only if the same entry is already queued
+ * - Otherwise the timer thread waits for a free slot; a stop request while
+ *   waiting discards the expiration
+ */
+static void service_enqueue(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry)
+{
+    if (service->count == service->capacity) {
+        if (service->policy == SOFTWARETIMER_SERVICE_DROP || (service->policy == SOFTWARETIMER_SERVICE_COALESCE && service_is_queued(service, entry))) {
+            service->dropped++;
+            return;
+        }
+        while (service->count == service->capacity && service->running) {
+            pthread_cond_wait(&service->notFull, &service->lock);
+        }
+        if (!service->running)
+            return;
+    }
+
+    service->queue[(service->head + service->count) % service->capacity] = entry;
+    service->count++;
+    pthread_cond_signal(&service->notEmpty);
+}
+
+/**
+ * Timer thread: moves expired entries to the queue and sleeps until the
+ * next deadline or until the set of entries changes.
+ */
+static void * service_timer_thread(void * arg)
+{
+    SoftwareTimer_Service * service = (SoftwareTimer_Service *) arg;
+
+    pthread_mutex_lock(&service->lock);
+    while (service->running) {
+        uint32_t now = SoftwareTimer_Now();
+        SoftwareTimer_Entry * entry;
+        struct timespec deadline;
+
+        while (service->running && (entry = SoftwareTimer_ManagerPopExpired(&service->manager, now)) != NULL) {
+            service_enqueue(service, entry);
+        }
+        if (!service->running)
+            break;
+
+        if (SoftwareTimer_ManagerNextTimespec(&service->manager, &deadline))
+            pthread_cond_timedwait(&service->changed, &service->lock, &deadline);
+        else
+            pthread_cond_wait(&service->changed, &service->lock);
+    }
+    pthread_mutex_unlock(&service->lock);
+    return NULL;
+}
+
+/**
+ * Worker thread: executes queued callbacks with the lock released. Exits
+ * after a stop request once the queue is drained.
+ */
+static void * service_worker_thread(void * arg)
+{
+    SoftwareTimer_Service * service = (SoftwareTimer_Service *) arg;
+
+    pthread_mutex_lock(&service->lock);
+    while (1) {
+        while (service->count == 0 && service->running) {
+            pthread_cond_wait(&service->notEmpty, &service->lock);
+        }
+        if (service->count == 0)
+            break;
+
+        SoftwareTimer_Entry * entry = service->queue[service->head];
+        service->head = (service->head + 1) % service->capacity;
+        service->count--;
+        pthread_cond_signal(&service->notFull);
+
+        pthread_mutex_unlock(&service->lock);
+        entry->callback(entry);
+        pthread_mutex_lock(&service->lock);
+    }
+    pthread_mutex_unlock(&service->lock);
+    return NULL;
+}
+
+/**
+ * Requests stop, wakes every thread and joins the first @p workers workers
+ * and, if @p timerThread is set, the timer thread.
+ */
+static void service_shutdown(SoftwareTimer_Service * service, uint32_t workers, bool timerThread)
+{
+    pthread_mutex_lock(&service->lock);
+    service->running = false;
+    pthread_cond_broadcast(&service->changed);
+    pthread_cond_broadcast(&service->notEmpty);
+    pthread_cond_broadcast(&service->notFull);
+    pthread_mutex_unlock(&service->lock);
+
+    if (timerThread)
+        pthread_join(service->timerThread, NULL);
+    for (uint32_t i = 0; i < workers; i++) {
+        pthread_join(service->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&service->notFull);
+    pthread_cond_destroy(&service->notEmpty);
+    pthread_cond_destroy(&service->changed);
+    pthread_mutex_destroy(&service->lock);
+}
+
+/**
+ * Initializes the synchronization objects and creates the threads. On
+ * failure the already created threads are stopped again.
+ */
+int SoftwareTimer_ServiceStart(SoftwareTimer_Service * service, SoftwareTimer_Entry ** queue, uint32_t capacity, pthread_t * workers, uint32_t workerCount, SoftwareTimer_ServicePolicy policy)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    SOFTWARETIMER_ASSERT(queue != NULL);
+    SOFTWARETIMER_ASSERT(capacity > 0);
+    SOFTWARETIMER_ASSERT(workers != NULL);
+    SOFTWARETIMER_ASSERT(workerCount > 0);
+
+    pthread_condattr_t attr;
+    int result;
+
+    SoftwareTimer_ManagerInit(&service->manager);
+    service->queue = queue;
+    service->capacity = capacity;
+    service->head = 0;
+    service->count = 0;
+    service->dropped = 0;
+    service->policy = policy;
+    service->workers = workers;
+    service->workerCount = workerCount;
+    service->running = true;
+
+    pthread_mutex_init(&service->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&service->changed, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&service->notEmpty, NULL);
+    pthread_cond_init(&service->notFull, NULL);
+
+    for (uint32_t i = 0; i < workerCount; i++) {
+        result = pthread_create(&workers[i], NULL, service_worker_thread, service);
+        if (result != 0) {
+            service_shutdown(service, i, false);
+            return result;
+        }
+    }
+    result = pthread_create(&service->timerThread, NULL, service_timer_thread, service);
+    if (result != 0) {
+        service_shutdown(service, workerCount, false);
+        return result;
+    }
+    return 0;
+}
+
+/**
+ * Stops and joins all threads.
+ */
+void SoftwareTimer_ServiceStop(SoftwareTimer_Service * service)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    service_shutdown(service, service->workerCount, true);
+}
+
+/**
+ * Arms the entry under the lock and wakes the timer thread so that it
+ * recomputes its wait deadline.
+ */
+void SoftwareTimer_ServiceArm(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry, uint32_t interval)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    pthread_mutex_lock(&service->lock);
+    SoftwareTimer_ManagerStart(&service->manager, entry, interval);
+    pthread_cond_signal(&service->changed);
+    pthread_mutex_unlock(&service->lock);
+}
+
+/**
+ * Arms the periodic entry under the lock and wakes the timer thread.
+ */
+void SoftwareTimer_ServiceArmPeriodic(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry, uint32_t period)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    pthread_mutex_lock(&service->lock);
+    SoftwareTimer_ManagerStartPeriodic(&service->manager, entry, period);
+    pthread_cond_signal(&service->changed);
+    pthread_mutex_unlock(&service->lock);
+}
+
+/**
+ * Disarms the entry under the lock. A later deadline never requires waking
+ * the timer thread early, so no signal is sent.
+ */
+void SoftwareTimer_ServiceDisarm(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    pthread_mutex_lock(&service->lock);
+    SoftwareTimer_ManagerStop(&service->manager, entry);
+    pthread_mutex_unlock(&service->lock);
+}
+
+/**
+ * Reads the dropped counter under the lock.
+ */
+uint32_t SoftwareTimer_ServiceDropped(SoftwareTimer_Service * service)
+{
+    SOFTWARETIMER_ASSERT(service != NULL);
+    pthread_mutex_lock(&service->lock);
+    uint32_t dropped = service->dropped;
+    pthread_mutex_unlock(&service->lock);
+    return dropped;
+}
+
+/** @} */
+
+#else
+
+// ISO C forbids an empty translation unit
+typedef int software_timer_service_disabled;
+
+#endif // defined(__unix__)
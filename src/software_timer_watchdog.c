@@ -0,0 +1,93 @@
+/**
+ * @file software_timer_watchdog.c
+ * @brief Software watchdog multiplexer implementation
+ * @author Richard Kubíček
+ *
+ * The cached earliest deadline is a lower bound of all slot deadlines:
+ * check-ins only move a deadline later and never touch the cache. A rescan
+ * replaces the bound with the exact minimum.
+ *
+ * @see software_timer_watchdog.h for API documentation
+ */
+
+#include "software_timer_watchdog.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_watchdog
+ * @{
+ */
+
+/**
+ * Copies the timeouts into the slots, checks every task in and computes
+ * the first cached deadline.
+ */
+void SoftwareTimer_WatchdogInit(SoftwareTimer_Watchdog * watchdog, SoftwareTimer * slots, const uint32_t * timeouts, uint32_t count)
+{
+    SOFTWARETIMER_ASSERT(watchdog != NULL);
+    SOFTWARETIMER_ASSERT(slots != NULL);
+    SOFTWARETIMER_ASSERT(timeouts != NULL);
+    SOFTWARETIMER_ASSERT(count > 0);
+    uint32_t now = SoftwareTimer_Now();
+    uint32_t shortest = INT32_MAX;
+
+    for (uint32_t i = 0; i < count; i++) {
+        SOFTWARETIMER_ASSERT(timeouts[i] > 0 && timeouts[i] <= INT32_MAX);
+        slots[i].start = now;
+        slots[i].interval = timeouts[i];
+        slots[i].evaluated = false;
+        if (timeouts[i] < shortest)
+            shortest = timeouts[i];
+    }
+
+    watchdog->slots = slots;
+    watchdog->count = count;
+    watchdog->earliest = now + shortest;
+}
+
+/**
+ * Stores the current time as the start of the task's slot.
+ */
+void SoftwareTimer_WatchdogCheckIn(SoftwareTimer_Watchdog * watchdog, uint32_t task)
+{
+    SOFTWARETIMER_ASSERT(watchdog != NULL);
+    SOFTWARETIMER_ASSERT(task < watchdog->count);
+    watchdog->slots[task].start = SoftwareTimer_Now();
+}
+
+/**
+ * Compares the clock with the cached deadline and rescans when it passed.
+ *
+ * Implementation:
+ * - Remaining times are signed distances from the same timestamp, so the
+ *   comparison is correct across a clock wrap
+ * - The rescan finds the smallest remaining time; if it is positive it
+ *   becomes the new cached deadline, otherwise its task is reported
+ */
+uint32_t SoftwareTimer_WatchdogCheck(SoftwareTimer_Watchdog * watchdog)
+{
+    SOFTWARETIMER_ASSERT(watchdog != NULL);
+    uint32_t now = SoftwareTimer_Now();
+
+    if ((int32_t) (watchdog->earliest - now) > 0)
+        return SOFTWARETIMER_WATCHDOG_ALIVE;
+
+    uint32_t worst = 0;
+    int32_t shortest = INT32_MAX;
+    for (uint32_t i = 0; i < watchdog->count; i++) {
+        const SoftwareTimer * slot = &watchdog->slots[i];
+        int32_t remaining = (int32_t) (slot->start + slot->interval - now);
+        if (remaining < shortest) {
+            shortest = remaining;
+            worst = i;
+        }
+    }
+
+    if (shortest <= 0)
+        return worst;
+    watchdog->earliest = now + (uint32_t) shortest;
+    return SOFTWARETIMER_WATCHDOG_ALIVE;
+}
+
+/** @} */
@@ -0,0 +1,102 @@
+/**
+ * @file software_timer_window.c
+ * @brief Sliding-window event counter implementation
+ * @author Richard Kubíček
+ *
+ * Buckets are advanced lazily: every operation first computes how many
+ * bucket widths elapsed since the current bucket started and clears that
+ * many buckets, subtracting them from the running sum.
+ *
+ * @see software_timer_window.h for API documentation
+ */
+
+#include "software_timer_window.h"
+#include "software_timer.h"
+#include "software_timer_private.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup software_timer_window
+ * @{
+ */
+
+/**
+ * Moves the current bucket forward to @p now.
+ *
+ * Implementation details:
+ * - Fast path returns after one comparison while the current bucket is open
+ * - Every elapsed bucket is cleared and subtracted from the running sum
+ * - If the whole window elapsed, all buckets are cleared in a single pass,
+ *   so a long idle period costs at most bucketCount iterations
+ * - headStart moves by whole bucket widths to keep bucket boundaries stable
+ */
+static void window_advance(SoftwareTimer_Window * window, uint32_t now)
+{
+    uint32_t elapsed = now - window->headStart;
+
+    if (elapsed < window->bucketWidth)
+        return;
+
+    uint32_t steps = elapsed / window->bucketWidth;
+    window->headStart += steps * window->bucketWidth;
+
+    if (steps >= window->bucketCount) {
+        for (uint32_t i = 0; i < window->bucketCount; i++) {
+            window->buckets[i] = 0;
+        }
+        window->sum = 0;
+        return;
+    }
+
+    while (steps--) {
+        window->head++;
+        if (window->head == window->bucketCount)
+            window->head = 0;
+        window->sum -= window->buckets[window->head];
+        window->buckets[window->head] = 0;
+    }
+}
+
+/**
+ * Clears all buckets and starts the current bucket now.
+ */
+void SoftwareTimer_WindowInit(SoftwareTimer_Window * window, uint32_t * buckets, uint32_t bucketCount, uint32_t bucketWidth)
+{
+    SOFTWARETIMER_ASSERT(window != NULL);
+    SOFTWARETIMER_ASSERT(buckets != NULL);
+    SOFTWARETIMER_ASSERT(bucketCount > 0);
+    SOFTWARETIMER_ASSERT(bucketWidth > 0);
+
+    for (uint32_t i = 0; i < bucketCount; i++) {
+        buckets[i] = 0;
+    }
+    window->buckets = buckets;
+    window->bucketCount = bucketCount;
+    window->bucketWidth = bucketWidth;
+    window->head = 0;
+    window->headStart = SoftwareTimer_Now();
+    window->sum = 0;
+}
+
+/**
+ * Advances the window and accounts the events in the current bucket.
+ */
+void SoftwareTimer_WindowAdd(SoftwareTimer_Window * window, uint32_t amount)
+{
+    SOFTWARETIMER_ASSERT(window != NULL);
+    window_advance(window, SoftwareTimer_Now());
+    window->buckets[window->head] += amount;
+    window->sum += amount;
+}
+
+/**
+ * Advances the window and returns the running sum.
+ */
+uint32_t SoftwareTimer_WindowSum(SoftwareTimer_Window * window)
+{
+    SOFTWARETIMER_ASSERT(window != NULL);
+    window_advance(window, SoftwareTimer_Now());
+    return window->sum;
+}
+
+/** @} */
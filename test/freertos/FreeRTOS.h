@@ -0,0 +1,25 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stub of the FreeRTOS types used by software_timer_freertos.c
+ *
+ * Only what the integration module needs; the kernel functions are
+ * implemented by the test. Build the tests with -DSOFTWARETIMER_FREERTOS
+ * and -I test/freertos to exercise the module on the host.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void * TaskHandle_t;
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE ((BaseType_t) 1)
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFu)
+#define configUSE_16_BIT_TICKS 0
+
+#endif // FREERTOS_H
@@ -0,0 +1,26 @@
+/**
+ * @file task.h
+ * @brief Host stub of the FreeRTOS task API used by software_timer_freertos.c
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "FreeRTOS.h"
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t * higherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+
+void vTaskEnterCritical(void);
+void vTaskExitCritical(void);
+UBaseType_t uxTaskEnterCriticalFromISR(void);
+void vTaskExitCriticalFromISR(UBaseType_t state);
+
+#define taskENTER_CRITICAL() vTaskEnterCritical()
+#define taskEXIT_CRITICAL() vTaskExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR() uxTaskEnterCriticalFromISR()
+#define taskEXIT_CRITICAL_FROM_ISR(state) vTaskExitCriticalFromISR(state)
+
+#endif // TASK_H
@@ -0,0 +1,97 @@
+/**
+ * @file liburing.h
+ * @brief Host stub of the liburing calls used by software_timer_iouring.c
+ *
+ * Only what the io_uring backend needs. Prepared SQEs stay in the ring for
+ * the test to inspect; submitting clears the queue. io_uring_queue_init and
+ * io_uring_queue_exit are implemented by the test, which decides whether the
+ * ring can be created. Build the tests with -DSOFTWARETIMER_IOURING and
+ * -I test/liburing to exercise the module on the host.
+ */
+
+#ifndef LIBURING_H
+#define LIBURING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IORING_OP_TIMEOUT 11
+#define IORING_OP_TIMEOUT_REMOVE 12
+#define IORING_TIMEOUT_ABS (1u << 0)
+#define IORING_TIMEOUT_UPDATE (1u << 1)
+
+struct __kernel_timespec {
+    int64_t tv_sec;
+    long long tv_nsec;
+};
+
+struct io_uring_sqe {
+    uint8_t opcode;
+    uint64_t off;
+    uint64_t addr;
+    uint32_t len;
+    uint32_t timeout_flags;
+    uint64_t user_data;
+};
+
+struct io_uring_cqe {
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+};
+
+struct io_uring {
+    struct io_uring_sqe sq[2];
+    unsigned queued;
+    unsigned submits;
+};
+
+int io_uring_queue_init(unsigned entries, struct io_uring * ring, unsigned flags);
+void io_uring_queue_exit(struct io_uring * ring);
+
+static inline struct io_uring_sqe * io_uring_get_sqe(struct io_uring * ring)
+{
+    if (ring->queued == sizeof(ring->sq) / sizeof(ring->sq[0]))
+        return NULL;
+    return &ring->sq[ring->queued++];
+}
+
+static inline int io_uring_submit(struct io_uring * ring)
+{
+    int submitted = (int) ring->queued;
+    ring->queued = 0;
+    ring->submits++;
+    return submitted;
+}
+
+static inline void io_uring_prep_timeout(struct io_uring_sqe * sqe, struct __kernel_timespec * ts, unsigned count, unsigned flags)
+{
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = (uint64_t) (uintptr_t) ts;
+    sqe->len = 1;
+    sqe->off = count;
+    sqe->timeout_flags = flags;
+}
+
+static inline void io_uring_prep_timeout_remove(struct io_uring_sqe * sqe, uint64_t user_data, unsigned flags)
+{
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->addr = user_data;
+    sqe->off = 0;
+    sqe->timeout_flags = flags;
+}
+
+static inline void io_uring_prep_timeout_update(struct io_uring_sqe * sqe, struct __kernel_timespec * ts, uint64_t user_data, unsigned flags)
+{
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->addr = user_data;
+    sqe->off = (uint64_t) (uintptr_t) ts;
+    sqe->timeout_flags = flags | IORING_TIMEOUT_UPDATE;
+}
+
+static inline void io_uring_sqe_set_data64(struct io_uring_sqe * sqe, uint64_t data)
+{
+    sqe->user_data = data;
+}
+
+#endif // LIBURING_H
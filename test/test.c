@@ -8,14 +8,74 @@
  * - Clock overflow scenarios
  * - Multiple timer instances
  * - Remaining time calculations
+ * - Time unit to tick conversions
+ * - Multi-shot (repeat count) timers
+ * - Delta-compressed timer groups
+ * - Phase-locked periodic timers
+ * - Suspend/resume across low-power modes
+ * - Sliding-window event counter
+ * - Timer manager and cooperative scheduler
+ * - Broadcast timers with many subscribers
+ * - Lock-free arming from many threads (C11 builds only)
+ * - Manager shared by many threads (SOFTWARETIMER_CRITICAL hosted builds)
+ * - Earliest-deadline-first executor
+ * - Cyclic executive frame tables
+ * - Deadline contexts with cascading cancel
+ * - State-machine timeouts
+ * - Watchdog multiplexer
+ * - Statistics and metrics formatters (SOFTWARETIMER_STATS builds only)
+ * - POSIX I/O wait helpers (hosted builds only) and timer service thread
+ *   (Unix builds only, not macOS)
+ * - FreeRTOS integration against the kernel stub in test/freertos
+ *   (SOFTWARETIMER_FREERTOS builds only)
+ * - io_uring timeout backend against the liburing stub in test/liburing
+ *   (SOFTWARETIMER_IOURING builds on Linux only)
  */
 
 #include "unity.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+#ifdef SOFTWARETIMER_FREERTOS
+    #include <setjmp.h>
+#endif
+#ifdef __linux__
+    #include <errno.h>
+    #include <sys/timerfd.h>
+#endif
 
 #include "software_timer.h"
+#include "software_timer_broadcast.h"
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+    #include "software_timer_concurrent.h"
+#endif
+#include "software_timer_context.h"
+#include "software_timer_cyclic.h"
+#include "software_timer_edf.h"
+#ifdef SOFTWARETIMER_FREERTOS
+    #include "software_timer_freertos.h"
+#endif
+#include "software_timer_fsm.h"
+#include "software_timer_group.h"
+#if defined(SOFTWARETIMER_IOURING) && defined(__linux__)
+    #include "software_timer_iouring.h"
+#endif
+#include "software_timer_metrics.h"
+#include "software_timer_pll.h"
+#include "software_timer_scheduler.h"
+#include "software_timer_units.h"
+#include "software_timer_watchdog.h"
+#include "software_timer_window.h"
+#if defined(__unix__) || defined(__APPLE__)
+    #include "software_timer_posix.h"
+#endif
+#if defined(__unix__)
+    #include "software_timer_service.h"
+#endif
 
 /* Test fixture data */
 static uint32_t mock_time = 0;
@@ -382,6 +442,2139 @@ void test_SoftwareTimer_StateConsistency(void)
     TEST_ASSERT_TRUE(SoftwareTimer_IsExpired(&timer));
 }
 
+void test_SoftwareTimer_Repeating_FiresExactCount(void)
+{
+    SoftwareTimer_Repeating timer;
+
+    SoftwareTimer_SetRepeating(&timer, 100, 3);
+    TEST_ASSERT_EQUAL(3, SoftwareTimer_RepeatsLeft(&timer));
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+
+    for (int i = 0; i < 3; i++) {
+        advance_time(99);
+        TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+        advance_time(1);
+        TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+        TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+    }
+
+    // Exhausted timer stays silent
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_RepeatsLeft(&timer));
+    advance_time(1000);
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+}
+
+void test_SoftwareTimer_Repeating_NoDrift(void)
+{
+    SoftwareTimer_Repeating timer;
+
+    SoftwareTimer_SetRepeating(&timer, 100, 2);
+
+    // Late poll must not shift the next period
+    advance_time(130);
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+    advance_time(69);
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+    advance_time(1);
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+}
+
+void test_SoftwareTimer_Repeating_CatchUpAndOverflow(void)
+{
+    SoftwareTimer_Repeating timer;
+    mock_time = UINT32_MAX - 50;
+
+    SoftwareTimer_SetRepeating(&timer, 100, 3);
+
+    // Several periods elapsed across the wrap: each call reports one
+    advance_time(350);
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredRepeating(&timer));
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+}
+
+void test_SoftwareTimer_Repeating_ZeroCount(void)
+{
+    SoftwareTimer_Repeating timer;
+
+    SoftwareTimer_SetRepeating(&timer, 0, 0);
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredRepeating(&timer));
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_RepeatsLeft(&timer));
+}
+
+void test_SoftwareTimer_Window_CountsWithinWindow(void)
+{
+    uint32_t buckets[4];
+    SoftwareTimer_Window window;
+
+    SoftwareTimer_WindowInit(&window, buckets, 4, 10);
+
+    SoftwareTimer_WindowAdd(&window, 1);
+    advance_time(10);
+    SoftwareTimer_WindowAdd(&window, 2);
+    advance_time(10);
+    SoftwareTimer_WindowAdd(&window, 3);
+    TEST_ASSERT_EQUAL(6, SoftwareTimer_WindowSum(&window));
+
+    // Oldest bucket slides out after four bucket widths
+    advance_time(20);
+    TEST_ASSERT_EQUAL(5, SoftwareTimer_WindowSum(&window));
+    advance_time(10);
+    TEST_ASSERT_EQUAL(3, SoftwareTimer_WindowSum(&window));
+    advance_time(10);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_WindowSum(&window));
+}
+
+void test_SoftwareTimer_Window_LongIdleAndOverflow(void)
+{
+    uint32_t buckets[8];
+    SoftwareTimer_Window window;
+    mock_time = UINT32_MAX - 15;
+
+    SoftwareTimer_WindowInit(&window, buckets, 8, 10);
+    SoftwareTimer_WindowAdd(&window, 5);
+
+    // Bucket boundaries survive the clock wrap
+    advance_time(30);
+    SoftwareTimer_WindowAdd(&window, 7);
+    TEST_ASSERT_EQUAL(12, SoftwareTimer_WindowSum(&window));
+
+    // Jump far ahead clears the whole window
+    advance_time(1000000);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_WindowSum(&window));
+    SoftwareTimer_WindowAdd(&window, 1);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_WindowSum(&window));
+}
+
+static int fired_order[8];
+static int fired_count;
+
+static void record_callback(SoftwareTimer_Entry * entry)
+{
+    fired_order[fired_count++] = *(const int *) entry->context;
+}
+
+void test_SoftwareTimer_Manager_FiresInDeadlineOrder(void)
+{
+    static const int ids[3] = {0, 1, 2};
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[3];
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &ids[i]);
+    }
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 300);
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 100);
+    SoftwareTimer_ManagerStart(&manager, &entries[2], 200);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    advance_time(99);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(0, fired_count);
+
+    advance_time(201);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(3, fired_count);
+    TEST_ASSERT_EQUAL(1, fired_order[0]);
+    TEST_ASSERT_EQUAL(2, fired_order[1]);
+    TEST_ASSERT_EQUAL(0, fired_order[2]);
+    TEST_ASSERT_FALSE(SoftwareTimer_EntryIsActive(&entries[0]));
+}
+
+void test_SoftwareTimer_Manager_PeriodicAndStop(void)
+{
+    static const int id = 7;
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry periodic;
+    fired_count = 0;
+    mock_time = UINT32_MAX - 10;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_EntryInit(&periodic, record_callback, (void *) &id);
+    SoftwareTimer_ManagerStartPeriodic(&manager, &periodic, 100);
+
+    // Late processing does not shift the period, also across the clock wrap
+    advance_time(120);
+    TEST_ASSERT_EQUAL(80, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    advance_time(80);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, fired_count);
+
+    SoftwareTimer_ManagerStop(&manager, &periodic);
+    SoftwareTimer_ManagerStop(&manager, &periodic);
+    advance_time(500);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, fired_count);
+}
+
+static uint32_t repeating_left[4];
+
+static void repeating_callback(SoftwareTimer_Entry * entry)
+{
+    repeating_left[fired_count++] = SoftwareTimer_EntryIsActive(entry) ? entry->remaining : UINT32_MAX;
+}
+
+void test_SoftwareTimer_Manager_RepeatingStopsAfterCount(void)
+{
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry retransmit;
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_EntryInit(&retransmit, repeating_callback, NULL);
+    SoftwareTimer_ManagerStartRepeating(&manager, &retransmit, 100, 3);
+
+    advance_time(100);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerProcess(&manager));
+    // A late pass coalesces missed periods into one expiration of the count
+    advance_time(350);
+    TEST_ASSERT_EQUAL(50, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, retransmit.missed);
+    advance_time(50);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(3, fired_count);
+    TEST_ASSERT_EQUAL(2, repeating_left[0]);
+    TEST_ASSERT_EQUAL(1, repeating_left[1]);
+    TEST_ASSERT_EQUAL(UINT32_MAX, repeating_left[2]); // last one already unlinked
+    TEST_ASSERT_EQUAL(0, retransmit.remaining);
+    TEST_ASSERT_FALSE(SoftwareTimer_EntryIsActive(&retransmit));
+
+    // Re-arming as plain periodic clears the count; count 0 stops the entry
+    SoftwareTimer_ManagerStartRepeating(&manager, &retransmit, 100, 1);
+    SoftwareTimer_ManagerStartPeriodic(&manager, &retransmit, 100);
+    advance_time(200);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_TRUE(SoftwareTimer_EntryIsActive(&retransmit));
+    SoftwareTimer_ManagerStartRepeating(&manager, &retransmit, 100, 0);
+    TEST_ASSERT_FALSE(SoftwareTimer_EntryIsActive(&retransmit));
+    TEST_ASSERT_EQUAL(4, fired_count);
+}
+
+static bool scheduler_flag;
+static int scheduler_steps;
+
+static void scheduler_test_task(SoftwareTimer_Task * task)
+{
+    SOFTWARETIMER_TASK_BEGIN(task);
+    scheduler_steps = 1;
+    SOFTWARETIMER_TASK_DELAY(task, 100);
+    scheduler_steps = 2;
+    SOFTWARETIMER_TASK_WAIT_UNTIL(task, scheduler_flag);
+    scheduler_steps = 3;
+    SOFTWARETIMER_TASK_END(task);
+}
+
+void test_SoftwareTimer_Scheduler_DelayAndWait(void)
+{
+    SoftwareTimer_Scheduler scheduler;
+    SoftwareTimer_Task task;
+    scheduler_flag = false;
+    scheduler_steps = 0;
+
+    SoftwareTimer_SchedulerInit(&scheduler);
+    SoftwareTimer_TaskStart(&scheduler, &task, scheduler_test_task, NULL);
+
+    // First pass runs until the delay, then the CPU may sleep 100 ticks
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_SchedulerRun(&scheduler));
+    TEST_ASSERT_EQUAL(1, scheduler_steps);
+
+    advance_time(60);
+    TEST_ASSERT_EQUAL(40, SoftwareTimer_SchedulerRun(&scheduler));
+    TEST_ASSERT_EQUAL(1, scheduler_steps);
+
+    // Waiting on a condition keeps the task runnable
+    advance_time(40);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_SchedulerRun(&scheduler));
+    TEST_ASSERT_EQUAL(2, scheduler_steps);
+
+    scheduler_flag = true;
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_SchedulerRun(&scheduler));
+    TEST_ASSERT_EQUAL(3, scheduler_steps);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_TASK_DONE, task.state);
+}
+
+static int edf_order[8];
+static int edf_count;
+
+static void edf_record(SoftwareTimer_Job * job)
+{
+    edf_order[edf_count++] = *(const int *) job->context;
+}
+
+void test_SoftwareTimer_Edf_RunsEarliestDeadlineFirst(void)
+{
+    static const int ids[4] = {0, 1, 2, 3};
+    SoftwareTimer_Job * storage[4];
+    SoftwareTimer_Job jobs[4];
+    SoftwareTimer_Edf edf;
+    static const uint32_t deadlines[4] = {400, 100, 300, 200};
+    edf_count = 0;
+    mock_time = UINT32_MAX - 150;
+
+    SoftwareTimer_EdfInit(&edf, storage, 4);
+    for (int i = 0; i < 4; i++) {
+        SoftwareTimer_JobInit(&jobs[i], edf_record, (void *) &ids[i], 10);
+        TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_ACCEPTED, SoftwareTimer_EdfSubmit(&edf, &jobs[i], deadlines[i]));
+    }
+    TEST_ASSERT_EQUAL(4, SoftwareTimer_EdfPending(&edf));
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_FULL, SoftwareTimer_EdfSubmit(&edf, &jobs[0], 500));
+
+    while (SoftwareTimer_EdfRunNext(&edf)) {
+    }
+    TEST_ASSERT_EQUAL(4, edf_count);
+    TEST_ASSERT_EQUAL(1, edf_order[0]);
+    TEST_ASSERT_EQUAL(3, edf_order[1]);
+    TEST_ASSERT_EQUAL(2, edf_order[2]);
+    TEST_ASSERT_EQUAL(0, edf_order[3]);
+    TEST_ASSERT_FALSE(SoftwareTimer_EdfRunNext(&edf));
+}
+
+void test_SoftwareTimer_Edf_AdmissionControl(void)
+{
+    static const int id = 0;
+    SoftwareTimer_Job * storage[4];
+    SoftwareTimer_Job first, second, third;
+    SoftwareTimer_Edf edf;
+
+    SoftwareTimer_EdfInit(&edf, storage, 4);
+    SoftwareTimer_JobInit(&first, edf_record, (void *) &id, 60);
+    SoftwareTimer_JobInit(&second, edf_record, (void *) &id, 50);
+    SoftwareTimer_JobInit(&third, edf_record, (void *) &id, 30);
+
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_ACCEPTED, SoftwareTimer_EdfSubmit(&edf, &first, 100));
+
+    // Does not fit after the earlier job
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_REJECTED, SoftwareTimer_EdfSubmit(&edf, &second, 100));
+
+    // Would fit itself, but pushes the pending job past its deadline
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_REJECTED, SoftwareTimer_EdfSubmit(&edf, &second, 50));
+
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_EDF_ACCEPTED, SoftwareTimer_EdfSubmit(&edf, &third, 40));
+    TEST_ASSERT_EQUAL(90, edf.backlog);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void test_SoftwareTimer_Posix_ToTimespec(void)
+{
+    SoftwareTimer timer;
+    struct timespec timeout;
+
+    SoftwareTimer_Set(&timer, 2500);
+    advance_time(1);
+    SoftwareTimer_ToTimespec(&timer, &timeout);
+    TEST_ASSERT_EQUAL(2, timeout.tv_sec);
+    TEST_ASSERT_EQUAL(499000000L, timeout.tv_nsec);
+
+    // Fractional nanoseconds round up at any tick rate, never below the ticks
+    SoftwareTimer_Set(&timer, 1);
+    SoftwareTimer_ToTimespec(&timer, &timeout);
+    TEST_ASSERT_EQUAL(0, timeout.tv_sec);
+    TEST_ASSERT_EQUAL((1000000000u + SOFTWARETIMER_TICK_HZ - 1u) / SOFTWARETIMER_TICK_HZ, timeout.tv_nsec);
+    TEST_ASSERT_TRUE((uint64_t) timeout.tv_nsec * SOFTWARETIMER_TICK_HZ >= 1000000000u);
+
+    advance_time(5000);
+    SoftwareTimer_ToTimespec(&timer, &timeout);
+    TEST_ASSERT_EQUAL(0, timeout.tv_sec);
+    TEST_ASSERT_EQUAL(0, timeout.tv_nsec);
+}
+
+void test_SoftwareTimer_Posix_PollExpired(void)
+{
+    SoftwareTimer timer;
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    struct pollfd pfd = {.fd = fds[0], .events = POLLIN};
+
+    // Expired timer: a single non-blocking poll
+    SoftwareTimer_Set(&timer, 10);
+    advance_time(10);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_Poll(&pfd, 1, &timer));
+
+    // Ready descriptor is reported before the deadline
+    TEST_ASSERT_EQUAL(1, write(fds[1], "x", 1));
+    SoftwareTimer_Set(&timer, 1000);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_Poll(&pfd, 1, &timer));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void test_SoftwareTimer_Posix_ManagerNextTimespec(void)
+{
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entry;
+    struct timespec before, deadline;
+
+    SoftwareTimer_ManagerInit(&manager);
+    TEST_ASSERT_FALSE(SoftwareTimer_ManagerNextTimespec(&manager, &deadline));
+
+    SoftwareTimer_EntryInit(&entry, record_callback, NULL);
+    SoftwareTimer_ManagerStart(&manager, &entry, 2500);
+    clock_gettime(CLOCK_MONOTONIC, &before);
+    TEST_ASSERT_TRUE(SoftwareTimer_ManagerNextTimespec(&manager, &deadline));
+
+    int64_t delta = (int64_t) (deadline.tv_sec - before.tv_sec) * 1000000000 + (deadline.tv_nsec - before.tv_nsec);
+    TEST_ASSERT_TRUE(delta >= 2500000000LL && delta < 2600000000LL);
+    TEST_ASSERT_TRUE(deadline.tv_nsec < 1000000000L);
+}
+
+#ifdef __linux__
+static int64_t timerfd_left_ns(int fd)
+{
+    struct itimerspec spec;
+
+    TEST_ASSERT_EQUAL(0, timerfd_gettime(fd, &spec));
+    TEST_ASSERT_EQUAL(0, spec.it_interval.tv_sec);
+    TEST_ASSERT_EQUAL(0, spec.it_interval.tv_nsec);
+    return (int64_t) spec.it_value.tv_sec * 1000000000 + spec.it_value.tv_nsec;
+}
+
+void test_SoftwareTimer_Posix_TimerfdArm(void)
+{
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entry;
+    uint64_t expirations;
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    TEST_ASSERT_TRUE(fd >= 0);
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_EntryInit(&entry, record_callback, NULL);
+
+    // Earliest deadline is programmed as a one-shot timer
+    SoftwareTimer_ManagerStart(&manager, &entry, 2500);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_TimerfdArm(fd, &manager));
+    int64_t left = timerfd_left_ns(fd);
+    TEST_ASSERT_TRUE(left > 2400000000LL && left <= 2500000000LL);
+
+    // Nothing armed disarms it
+    SoftwareTimer_ManagerStop(&manager, &entry);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_TimerfdArm(fd, &manager));
+    TEST_ASSERT_EQUAL(0, timerfd_left_ns(fd));
+    TEST_ASSERT_EQUAL(0, poll(&pfd, 1, 0));
+
+    // Due entry makes it readable at once
+    SoftwareTimer_ManagerStart(&manager, &entry, 0);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_TimerfdArm(fd, &manager));
+    TEST_ASSERT_EQUAL(1, poll(&pfd, 1, 1000));
+    TEST_ASSERT_EQUAL(sizeof(expirations), read(fd, &expirations, sizeof(expirations)));
+    TEST_ASSERT_EQUAL(1, expirations);
+
+    close(fd);
+}
+#endif
+
+void test_SoftwareTimer_Posix_SleepUntilNeverEarly(void)
+{
+    SoftwareTimer_Sleeper sleeper;
+    SoftwareTimer timer;
+    struct timespec before, after;
+
+    SoftwareTimer_SleeperInit(&sleeper);
+    TEST_ASSERT_EQUAL(0, sleeper.margin);
+
+    for (int i = 0; i < 5; i++) {
+        SoftwareTimer_Set(&timer, 3);
+        clock_gettime(CLOCK_MONOTONIC, &before);
+        SoftwareTimer_SleepUntil(&sleeper, &timer);
+        clock_gettime(CLOCK_MONOTONIC, &after);
+
+        int64_t slept = (int64_t) (after.tv_sec - before.tv_sec) * 1000000000 + (after.tv_nsec - before.tv_nsec);
+        TEST_ASSERT_TRUE(slept >= 3000000);
+    }
+    // Wake latency is never zero, the margin has adapted
+    TEST_ASSERT_TRUE(sleeper.margin > 0);
+    TEST_ASSERT_TRUE(sleeper.margin <= SOFTWARETIMER_SLEEP_MAX_MARGIN_NS);
+
+    // Expired timer returns without sleeping
+    advance_time(3);
+    clock_gettime(CLOCK_MONOTONIC, &before);
+    SoftwareTimer_SleepUntil(&sleeper, &timer);
+    clock_gettime(CLOCK_MONOTONIC, &after);
+    TEST_ASSERT_TRUE((after.tv_sec - before.tv_sec) * 1000000000 + (after.tv_nsec - before.tv_nsec) < 1000000);
+}
+#endif
+
+#if defined(__unix__)
+static volatile int service_calls;
+
+static void service_callback(SoftwareTimer_Entry * entry)
+{
+    (void) entry;
+    __atomic_fetch_add(&service_calls, 1, __ATOMIC_SEQ_CST);
+}
+
+void test_SoftwareTimer_Service_DispatchesToWorkers(void)
+{
+    SoftwareTimer_Service service;
+    SoftwareTimer_Entry * queue[4];
+    pthread_t workers[2];
+    SoftwareTimer_Entry entries[3];
+    service_calls = 0;
+
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ServiceStart(&service, queue, 4, workers, 2, SOFTWARETIMER_SERVICE_BLOCK));
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_EntryInit(&entries[i], service_callback, NULL);
+        SoftwareTimer_ServiceArm(&service, &entries[i], 0);
+    }
+
+    for (int i = 0; i < 1000 && __atomic_load_n(&service_calls, __ATOMIC_SEQ_CST) < 3; i++) {
+        usleep(1000);
+    }
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ServiceDropped(&service));
+    SoftwareTimer_ServiceStop(&service);
+    TEST_ASSERT_EQUAL(3, service_calls);
+}
+
+static pthread_mutex_t service_gate_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t service_gate_changed = PTHREAD_COND_INITIALIZER;
+static bool service_gate_open;
+static bool service_gate_entered;
+static int service_counts[4];
+
+static void service_counting_callback(SoftwareTimer_Entry * entry)
+{
+    __atomic_fetch_add(&service_counts[*(const int *) entry->context], 1, __ATOMIC_SEQ_CST);
+}
+
+static void service_blocking_callback(SoftwareTimer_Entry * entry)
+{
+    pthread_mutex_lock(&service_gate_lock);
+    service_gate_entered = true;
+    pthread_cond_broadcast(&service_gate_changed);
+    while (!service_gate_open) {
+        pthread_cond_wait(&service_gate_changed, &service_gate_lock);
+    }
+    pthread_mutex_unlock(&service_gate_lock);
+    service_counting_callback(entry);
+}
+
+/**
+ * Starts a service with a single queue slot and blocks its only worker in
+ * the callback of entries[0]; entries[1..3] count their calls.
+ */
+static void service_start_blocked(SoftwareTimer_Service * service, SoftwareTimer_Entry ** queue, pthread_t * worker, SoftwareTimer_Entry * entries, SoftwareTimer_ServicePolicy policy)
+{
+    static const int ids[4] = {0, 1, 2, 3};
+
+    service_gate_open = false;
+    service_gate_entered = false;
+    for (int i = 0; i < 4; i++) {
+        service_counts[i] = 0;
+        SoftwareTimer_EntryInit(&entries[i], i == 0 ? service_blocking_callback : service_counting_callback, (void *) &ids[i]);
+    }
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ServiceStart(service, queue, 1, worker, 1, policy));
+
+    SoftwareTimer_ServiceArm(service, &entries[0], 0);
+    pthread_mutex_lock(&service_gate_lock);
+    while (!service_gate_entered) {
+        pthread_cond_wait(&service_gate_changed, &service_gate_lock);
+    }
+    pthread_mutex_unlock(&service_gate_lock);
+}
+
+/**
+ * Arms an entry that is due at once and waits until the timer thread took
+ * it from the manager (queued, dropped, or waiting for a free slot).
+ */
+static void service_expire(SoftwareTimer_Service * service, SoftwareTimer_Entry * entry)
+{
+    bool popped = false;
+
+    SoftwareTimer_ServiceArm(service, entry, 0);
+    for (int i = 0; i < 10000 && !popped; i++) {
+        pthread_mutex_lock(&service->lock);
+        popped = entry->timer.evaluated;
+        pthread_mutex_unlock(&service->lock);
+        if (!popped)
+            usleep(100);
+    }
+    TEST_ASSERT_TRUE(popped);
+}
+
+/**
+ * Releases the blocked worker and waits until @p id was called @p calls times.
+ */
+static void service_release(int id, int calls)
+{
+    pthread_mutex_lock(&service_gate_lock);
+    service_gate_open = true;
+    pthread_cond_broadcast(&service_gate_changed);
+    pthread_mutex_unlock(&service_gate_lock);
+
+    for (int i = 0; i < 10000 && __atomic_load_n(&service_counts[id], __ATOMIC_SEQ_CST) < calls; i++) {
+        usleep(100);
+    }
+}
+
+void test_SoftwareTimer_Service_DropDiscardsWhenFull(void)
+{
+    SoftwareTimer_Service service;
+    SoftwareTimer_Entry * queue[1];
+    pthread_t worker;
+    SoftwareTimer_Entry entries[4];
+
+    service_start_blocked(&service, queue, &worker, entries, SOFTWARETIMER_SERVICE_DROP);
+    service_expire(&service, &entries[1]); // takes the only slot
+    service_expire(&service, &entries[2]);
+    service_expire(&service, &entries[3]);
+    TEST_ASSERT_EQUAL(2, SoftwareTimer_ServiceDropped(&service));
+
+    service_release(1, 1);
+    SoftwareTimer_ServiceStop(&service);
+    TEST_ASSERT_EQUAL(1, service_counts[0]);
+    TEST_ASSERT_EQUAL(1, service_counts[1]);
+    TEST_ASSERT_EQUAL(0, service_counts[2]);
+    TEST_ASSERT_EQUAL(0, service_counts[3]);
+}
+
+void test_SoftwareTimer_Service_CoalesceMergesQueuedEntry(void)
+{
+    SoftwareTimer_Service service;
+    SoftwareTimer_Entry * queue[1];
+    pthread_t worker;
+    SoftwareTimer_Entry entries[4];
+
+    service_start_blocked(&service, queue, &worker, entries, SOFTWARETIMER_SERVICE_COALESCE);
+    service_expire(&service, &entries[1]);
+    service_expire(&service, &entries[1]); // merged into the queued expiration
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ServiceDropped(&service));
+
+    // Another entry is not merged: the timer thread waits for the slot
+    service_expire(&service, &entries[2]);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ServiceDropped(&service));
+
+    service_release(2, 1);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ServiceDropped(&service));
+    SoftwareTimer_ServiceStop(&service);
+    TEST_ASSERT_EQUAL(1, service_counts[1]);
+    TEST_ASSERT_EQUAL(1, service_counts[2]);
+}
+
+void test_SoftwareTimer_Service_BlockLosesNoExpiration(void)
+{
+    SoftwareTimer_Service service;
+    SoftwareTimer_Entry * queue[1];
+    pthread_t worker;
+    SoftwareTimer_Entry entries[4];
+
+    service_start_blocked(&service, queue, &worker, entries, SOFTWARETIMER_SERVICE_BLOCK);
+    service_expire(&service, &entries[1]);
+    service_expire(&service, &entries[1]); // timer thread waits with a second expiration of the same entry
+    SoftwareTimer_ServiceArm(&service, &entries[2], 0); // stays armed behind it
+    SoftwareTimer_ServiceArm(&service, &entries[3], 0);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ServiceDropped(&service));
+
+    service_release(3, 1);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ServiceDropped(&service));
+    SoftwareTimer_ServiceStop(&service);
+    TEST_ASSERT_EQUAL(1, service_counts[0]);
+    TEST_ASSERT_EQUAL(2, service_counts[1]);
+    TEST_ASSERT_EQUAL(1, service_counts[2]);
+    TEST_ASSERT_EQUAL(1, service_counts[3]);
+}
+#endif
+
+void test_SoftwareTimer_SuspendResume_RebasesAcrossSleep(void)
+{
+    SoftwareTimer timers[3];
+    SoftwareTimer_Retained retained[3];
+
+    SoftwareTimer_Set(&timers[0], 1000);
+    SoftwareTimer_Set(&timers[1], 300);
+    SoftwareTimer_Set(&timers[2], 50);
+    advance_time(100);
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredEvaluatedOnce(&timers[2]));
+
+    SoftwareTimer_Suspend(timers, retained, 3);
+    TEST_ASSERT_EQUAL(900, retained[0].remaining);
+    TEST_ASSERT_EQUAL(200, retained[1].remaining);
+    TEST_ASSERT_EQUAL(0, retained[2].remaining);
+
+    // Clock restarts from an unrelated value during sleep
+    mock_time = 12345;
+    SoftwareTimer_Resume(timers, retained, 3, 500);
+
+    TEST_ASSERT_EQUAL(400, SoftwareTimer_Remaining(&timers[0]));
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpiredEvaluatedOnce(&timers[1]));
+    TEST_ASSERT_FALSE(SoftwareTimer_IsExpiredEvaluatedOnce(&timers[2]));
+    TEST_ASSERT_TRUE(SoftwareTimer_IsExpired(&timers[2]));
+}
+
+void test_SoftwareTimer_Context_ChildBoundedByParent(void)
+{
+    static SoftwareTimer_Context request, query, retry;
+
+    SoftwareTimer_ContextInit(&request, NULL, 1000);
+    advance_time(200);
+    SoftwareTimer_ContextInit(&query, &request, 5000);
+    SoftwareTimer_ContextInit(&retry, &query, 100);
+
+    TEST_ASSERT_EQUAL(800, SoftwareTimer_ContextRemaining(&query));
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ContextRemaining(&retry));
+
+    advance_time(800);
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&request));
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&query));
+
+    // Child of a done parent is done immediately
+    SoftwareTimer_ContextInit(&retry, &query, 100);
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&retry));
+}
+
+void test_SoftwareTimer_Context_CascadingCancel(void)
+{
+    static SoftwareTimer_Context request, query, retry;
+
+    SoftwareTimer_ContextInit(&request, NULL, 1000);
+    SoftwareTimer_ContextInit(&query, &request, 500);
+    SoftwareTimer_ContextInit(&retry, &query, 100);
+    TEST_ASSERT_FALSE(SoftwareTimer_ContextIsDone(&retry));
+
+    SoftwareTimer_ContextCancel(&request);
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&request));
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&query));
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&retry));
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ContextRemaining(&retry));
+
+    // Re-using the parent for a new request does not revive old children
+    SoftwareTimer_ContextInit(&request, NULL, 1000);
+    TEST_ASSERT_FALSE(SoftwareTimer_ContextIsDone(&request));
+    TEST_ASSERT_TRUE(SoftwareTimer_ContextIsDone(&query));
+
+    // Cancelling a child leaves the parent running
+    SoftwareTimer_ContextInit(&query, &request, 500);
+    SoftwareTimer_ContextCancel(&query);
+    TEST_ASSERT_FALSE(SoftwareTimer_ContextIsDone(&request));
+}
+
+void test_SoftwareTimer_Units_ConstantConversion(void)
+{
+    // Default tick rate is 1 kHz
+    TEST_ASSERT_EQUAL(2000, SOFTWARETIMER_S(2));
+    TEST_ASSERT_EQUAL(250, SOFTWARETIMER_MS(250));
+    TEST_ASSERT_EQUAL(2, SOFTWARETIMER_US(1500)); // rounded up, never shorter
+    TEST_ASSERT_EQUAL(1, SOFTWARETIMER_US(1));
+    TEST_ASSERT_EQUAL(0, SOFTWARETIMER_US(0));
+    TEST_ASSERT_EQUAL(UINT32_MAX, SOFTWARETIMER_MS(4294967295u));
+}
+
+void test_SoftwareTimer_Units_RuntimeConversion(void)
+{
+    volatile uint32_t value = 1500;
+
+    TEST_ASSERT_EQUAL(1500, SoftwareTimer_MsToTicks(value));
+    TEST_ASSERT_EQUAL(2, SoftwareTimer_UsToTicks(value));
+    TEST_ASSERT_EQUAL(1500, SoftwareTimer_TicksToMs(value));
+    TEST_ASSERT_EQUAL(1500000, SoftwareTimer_TicksToUs(value));
+    TEST_ASSERT_TRUE(SoftwareTimer_TicksToUs(UINT32_MAX) == (uint64_t) UINT32_MAX * 1000u);
+}
+
+enum { FSM_IDLE, FSM_CONNECTING, FSM_UP, FSM_STATES };
+
+static const uint32_t fsm_timeouts[FSM_STATES] = {SOFTWARETIMER_FSM_NO_TIMEOUT, 200, 1000};
+static uint32_t fsm_timed_out_state;
+static int fsm_timeout_count;
+
+static void fsm_test_timeout(SoftwareTimer_Fsm * fsm, uint32_t state)
+{
+    fsm_timed_out_state = state;
+    fsm_timeout_count++;
+    SoftwareTimer_FsmEnter(fsm, FSM_IDLE);
+}
+
+void test_SoftwareTimer_Fsm_ManagerRearmsOnStateEntry(void)
+{
+    static SoftwareTimer_Manager manager;
+    static const SoftwareTimer_FsmTable table = {fsm_timeouts, FSM_STATES, fsm_test_timeout, &manager, NULL};
+    SoftwareTimer_Fsm machines[2];
+    fsm_timeout_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_FsmInit(&machines[0], &table, NULL, FSM_IDLE);
+    SoftwareTimer_FsmInit(&machines[1], &table, NULL, FSM_IDLE);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    SoftwareTimer_FsmEnter(&machines[0], FSM_CONNECTING);
+    SoftwareTimer_FsmEnter(&machines[1], FSM_CONNECTING);
+    advance_time(150);
+    SoftwareTimer_FsmEnter(&machines[1], FSM_UP); // connected, keep-alive timeout replaces connect timeout
+
+    advance_time(50);
+    TEST_ASSERT_EQUAL(950, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(1, fsm_timeout_count);
+    TEST_ASSERT_EQUAL(FSM_CONNECTING, fsm_timed_out_state);
+    TEST_ASSERT_EQUAL(FSM_IDLE, SoftwareTimer_FsmState(&machines[0]));
+    TEST_ASSERT_EQUAL(FSM_UP, SoftwareTimer_FsmState(&machines[1]));
+
+    SoftwareTimer_FsmStop(&machines[1]);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+}
+
+void test_SoftwareTimer_Fsm_QueuesShareOneManagerEntryPerState(void)
+{
+    static SoftwareTimer_Manager manager;
+    static SoftwareTimer_FsmQueue queues[FSM_STATES];
+    static const SoftwareTimer_FsmTable table = {fsm_timeouts, FSM_STATES, fsm_test_timeout, &manager, queues};
+    static SoftwareTimer_Fsm machines[100];
+    fsm_timeout_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_FsmQueuesInit(&table);
+    for (int i = 0; i < 100; i++)
+        SoftwareTimer_FsmInit(&machines[i], &table, NULL, FSM_IDLE);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    // Machines entering a state over time are queued behind one manager entry
+    for (int i = 0; i < 100; i++) {
+        SoftwareTimer_FsmEnter(&machines[i], FSM_CONNECTING);
+        advance_time(1);
+    }
+    TEST_ASSERT_EQUAL_PTR(&queues[FSM_CONNECTING].entry, manager.head);
+    TEST_ASSERT_NULL(manager.head->next);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    // Head machine leaves the state: the entry fires once early and re-arms
+    SoftwareTimer_FsmEnter(&machines[0], FSM_UP);
+    advance_time(100);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(0, fsm_timeout_count);
+
+    // Due machines time out in arming order
+    advance_time(50);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(50, fsm_timeout_count);
+    TEST_ASSERT_EQUAL(FSM_IDLE, SoftwareTimer_FsmState(&machines[50]));
+    TEST_ASSERT_EQUAL(FSM_CONNECTING, SoftwareTimer_FsmState(&machines[51]));
+
+    // Emptying a queue stops its entry
+    for (int i = 51; i < 100; i++)
+        SoftwareTimer_FsmStop(&machines[i]);
+    TEST_ASSERT_EQUAL_PTR(&queues[FSM_UP].entry, manager.head);
+    TEST_ASSERT_NULL(manager.head->next);
+    advance_time(850);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(51, fsm_timeout_count);
+    TEST_ASSERT_EQUAL(FSM_UP, fsm_timed_out_state);
+}
+
+void test_SoftwareTimer_Fsm_PollingWithoutManager(void)
+{
+    static const SoftwareTimer_FsmTable table = {fsm_timeouts, FSM_STATES, fsm_test_timeout, NULL, NULL};
+    SoftwareTimer_Fsm machine;
+    fsm_timeout_count = 0;
+
+    SoftwareTimer_FsmInit(&machine, &table, NULL, FSM_CONNECTING);
+    advance_time(199);
+    TEST_ASSERT_FALSE(SoftwareTimer_FsmPoll(&machine));
+
+    // Re-entering the state restarts its timeout
+    SoftwareTimer_FsmEnter(&machine, FSM_CONNECTING);
+    advance_time(199);
+    TEST_ASSERT_FALSE(SoftwareTimer_FsmPoll(&machine));
+    advance_time(1);
+    TEST_ASSERT_TRUE(SoftwareTimer_FsmPoll(&machine));
+    TEST_ASSERT_EQUAL(FSM_IDLE, SoftwareTimer_FsmState(&machine));
+
+    // States without a timeout never fire
+    advance_time(100000);
+    TEST_ASSERT_FALSE(SoftwareTimer_FsmPoll(&machine));
+    TEST_ASSERT_EQUAL(1, fsm_timeout_count);
+}
+
+void test_SoftwareTimer_Watchdog_ReportsStarvedTask(void)
+{
+    static const uint32_t timeouts[3] = {500, 50, 2000};
+    SoftwareTimer slots[3];
+    SoftwareTimer_Watchdog watchdog;
+
+    SoftwareTimer_WatchdogInit(&watchdog, slots, timeouts, 3);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_WATCHDOG_ALIVE, SoftwareTimer_WatchdogCheck(&watchdog));
+
+    // Task 1 keeps checking in, the cache is refreshed by the rescan
+    for (int i = 0; i < 9; i++) {
+        advance_time(40);
+        SoftwareTimer_WatchdogCheckIn(&watchdog, 1);
+        TEST_ASSERT_EQUAL(SOFTWARETIMER_WATCHDOG_ALIVE, SoftwareTimer_WatchdogCheck(&watchdog));
+    }
+    TEST_ASSERT_EQUAL(360, mock_time);
+
+    // Task 0 stops checking in after 500 ticks
+    advance_time(140);
+    SoftwareTimer_WatchdogCheckIn(&watchdog, 1);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_WatchdogCheck(&watchdog));
+
+    SoftwareTimer_WatchdogCheckIn(&watchdog, 0);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_WATCHDOG_ALIVE, SoftwareTimer_WatchdogCheck(&watchdog));
+
+    // The most overdue task is reported
+    advance_time(2500);
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_WatchdogCheck(&watchdog));
+}
+
+#ifdef SOFTWARETIMER_STATS
+static void slow_callback(SoftwareTimer_Entry * entry)
+{
+    (void) entry;
+    advance_time(30);
+}
+
+static SoftwareTimer_Manager * late_arm_manager;
+static SoftwareTimer_Entry * late_arm_entry;
+static int late_arm_reads;
+
+// Clock that arms an entry with a past start on its second read, like an
+// interrupt arriving between the last pop and the end of the call
+static uint32_t late_arm_clock(void)
+{
+    if (++late_arm_reads == 2)
+        SoftwareTimer_ManagerStartFrom(late_arm_manager, late_arm_entry, mock_time - 50, 10, 0);
+    return mock_time;
+}
+
+void test_SoftwareTimer_Manager_ProcessClampsDueEntryToZero(void)
+{
+    static const int id = 0;
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[2];
+    fired_count = 0;
+    late_arm_reads = 0;
+    late_arm_manager = &manager;
+    late_arm_entry = &entries[1];
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_ManagerSetBudget(&manager, 1000); // second clock read after dispatch
+    SoftwareTimer_EntryInit(&entries[0], record_callback, (void *) &id);
+    SoftwareTimer_EntryInit(&entries[1], record_callback, (void *) &id);
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 0);
+    SoftwareTimer_Init(late_arm_clock);
+
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, fired_count);
+}
+
+void test_SoftwareTimer_Metrics_ManagerCounters(void)
+{
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[3];
+    SoftwareTimer_Metrics metrics;
+    static const int id = 0;
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_ManagerSetBudget(&manager, 20);
+    SoftwareTimer_EntryInit(&entries[0], record_callback, (void *) &id);
+    SoftwareTimer_EntryInit(&entries[1], record_callback, (void *) &id);
+    SoftwareTimer_EntryInit(&entries[2], slow_callback, NULL);
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 100);
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 95);
+    SoftwareTimer_ManagerStartPeriodic(&manager, &entries[2], 1000);
+
+    uint32_t reads = SoftwareTimer_ClockReads();
+    SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+    TEST_ASSERT_EQUAL(3, metrics.active);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_MetricsLatenessPercentile(&metrics, 50));
+
+    // Processed 0 and 5 ticks late, within budget
+    advance_time(100);
+    SoftwareTimer_ManagerProcess(&manager);
+    SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+    TEST_ASSERT_EQUAL(1, metrics.active);
+    TEST_ASSERT_EQUAL(2, metrics.expirations);
+    TEST_ASSERT_EQUAL(5, metrics.latenessSum);
+    TEST_ASSERT_EQUAL(1, metrics.lateness[0]);
+    TEST_ASSERT_EQUAL(1, metrics.lateness[3]);
+    TEST_ASSERT_EQUAL(0, metrics.overruns);
+    TEST_ASSERT_TRUE(metrics.clockReads - reads >= 2);
+
+    // Periodic entry stays active; its callback exceeds the budget
+    advance_time(1000);
+    SoftwareTimer_ManagerProcess(&manager);
+    SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+    TEST_ASSERT_EQUAL(1, metrics.active);
+    TEST_ASSERT_EQUAL(3, metrics.expirations);
+    TEST_ASSERT_EQUAL(1, metrics.overruns);
+    TEST_ASSERT_EQUAL(7, SoftwareTimer_MetricsLatenessPercentile(&metrics, 50));
+    TEST_ASSERT_EQUAL(127, SoftwareTimer_MetricsLatenessPercentile(&metrics, 90));
+}
+
+void test_SoftwareTimer_Metrics_Formatters(void)
+{
+    SoftwareTimer_Metrics metrics;
+    char text[2048];
+
+    memset(&metrics, 0, sizeof(metrics));
+    metrics.active = 2;
+    metrics.expirations = 10;
+    metrics.clockReads = 42;
+    metrics.latenessSum = 12;
+    metrics.lateness[0] = 8;
+    metrics.lateness[2] = 1;
+    metrics.lateness[SOFTWARETIMER_STATS_BUCKETS - 1] = 1;
+
+    int length = SoftwareTimer_MetricsFormatJson(&metrics, "main", text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("{\"engine\":\"main\",\"active\":2,\"expirations\":10,\"overruns\":0,\"clockReads\":42,"
+                             "\"lateness\":{\"sum\":12,\"buckets\":[8,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1],\"p50\":0,\"p90\":3,\"p99\":null}}",
+                             text);
+    TEST_ASSERT_EQUAL(strlen(text), length);
+
+    length = SoftwareTimer_MetricsFormatPrometheus(&metrics, "main", text, sizeof(text));
+    TEST_ASSERT_EQUAL(strlen(text), length);
+    TEST_ASSERT_NOT_NULL(strstr(text, "softwaretimer_active_timers{engine=\"main\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "softwaretimer_lateness_ticks_bucket{engine=\"main\",le=\"3\"} 9\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "softwaretimer_lateness_ticks_bucket{engine=\"main\",le=\"+Inf\"} 10\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "softwaretimer_lateness_ticks_count{engine=\"main\"} 10\n"));
+
+    // Truncated output reports the full length
+    char small[16];
+    TEST_ASSERT_EQUAL(length, SoftwareTimer_MetricsFormatPrometheus(&metrics, "main", small, sizeof(small)));
+    TEST_ASSERT_EQUAL(15, strlen(small));
+    TEST_ASSERT_EQUAL(length, SoftwareTimer_MetricsFormatPrometheus(&metrics, "main", NULL, 0));
+
+    // Engine names are escaped for each format
+    SoftwareTimer_MetricsFormatPrometheus(&metrics, "a\"b\\c\nd", text, sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text, "softwaretimer_active_timers{engine=\"a\\\"b\\\\c\\nd\"} 2\n"));
+    length = SoftwareTimer_MetricsFormatJson(&metrics, "a\"b\\c\nd\t", text, sizeof(text));
+    TEST_ASSERT_EQUAL(0, strncmp(text, "{\"engine\":\"a\\\"b\\\\c\\nd\\u0009\",\"active\":2,", 33));
+    TEST_ASSERT_EQUAL(strlen(text), length);
+    TEST_ASSERT_EQUAL(length, SoftwareTimer_MetricsFormatJson(&metrics, "a\"b\\c\nd\t", small, sizeof(small)));
+    TEST_ASSERT_EQUAL(15, strlen(small));
+}
+
+    #if defined(__unix__) || defined(__APPLE__)
+static int metrics_dispatching;
+
+static void metrics_noop_callback(SoftwareTimer_Entry * entry)
+{
+    (void) entry;
+}
+
+static void * metrics_processing_thread(void * arg)
+{
+    SoftwareTimer_Manager * manager = (SoftwareTimer_Manager *) arg;
+
+    for (int i = 0; i < 20000; i++) {
+        advance_time(1);
+        SoftwareTimer_ManagerProcess(manager);
+    }
+    __atomic_store_n(&metrics_dispatching, 0, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+void test_SoftwareTimer_Metrics_SnapshotFromAnotherThread(void)
+{
+    static SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[4];
+    SoftwareTimer_Metrics metrics;
+    uint32_t expirations = 0;
+    pthread_t thread;
+
+    SoftwareTimer_ManagerInit(&manager);
+    for (int i = 0; i < 4; i++) {
+        SoftwareTimer_EntryInit(&entries[i], metrics_noop_callback, NULL);
+        SoftwareTimer_ManagerStartPeriodic(&manager, &entries[i], 1);
+    }
+
+    // Snapshots never lock the manager and see the counters only grow
+    __atomic_store_n(&metrics_dispatching, 1, __ATOMIC_SEQ_CST);
+    pthread_create(&thread, NULL, metrics_processing_thread, &manager);
+    while (__atomic_load_n(&metrics_dispatching, __ATOMIC_SEQ_CST)) {
+        SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+        TEST_ASSERT_TRUE(metrics.expirations >= expirations);
+        TEST_ASSERT_TRUE(metrics.active >= 3 && metrics.active <= 4); // a periodic entry is re-linked
+        expirations = metrics.expirations;
+    }
+    pthread_join(thread, NULL);
+
+    SoftwareTimer_MetricsSnapshot(&manager, &metrics);
+    TEST_ASSERT_EQUAL(80000, metrics.expirations);
+    TEST_ASSERT_EQUAL(80000, metrics.lateness[0]);
+}
+    #endif
+#endif
+
+static bool visit_collect(const SoftwareTimer_EntryInfo * info, void * context)
+{
+    SoftwareTimer_EntryInfo * infos = (SoftwareTimer_EntryInfo *) context;
+    infos[fired_count++] = *info;
+    return fired_count < 2;
+}
+
+void test_SoftwareTimer_Manager_VisitInDeadlineOrder(void)
+{
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[3];
+    SoftwareTimer_EntryInfo infos[3];
+    static const int id = 0;
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &id);
+    }
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 300);
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 100);
+    SoftwareTimer_ManagerStartPeriodic(&manager, &entries[2], 200);
+    advance_time(150);
+
+    // The visitor stops the walk after two entries
+    TEST_ASSERT_EQUAL(2, SoftwareTimer_ManagerVisit(&manager, visit_collect, infos));
+    TEST_ASSERT_EQUAL_PTR(&entries[1], infos[0].entry);
+    TEST_ASSERT_EQUAL(0, infos[0].remaining);
+    TEST_ASSERT_EQUAL(50, infos[0].lateness);
+    TEST_ASSERT_EQUAL_PTR(&entries[2], infos[1].entry);
+    TEST_ASSERT_EQUAL(50, infos[1].remaining);
+    TEST_ASSERT_EQUAL(0, infos[1].lateness);
+
+#ifdef SOFTWARETIMER_STATS
+    char text[256];
+    SoftwareTimer_EntrySetTag(&entries[2], "heartbeat");
+    SoftwareTimer_EntrySetTag(&entries[0], "log\nflush");
+    SoftwareTimer_MetricsFormatDump(&manager, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(" remaining       late     period tag\n"
+                             "         0         50          0 -\n"
+                             "        50          0        200 heartbeat\n"
+                             "       150          0          0 log\\nflush\n",
+                             text);
+#endif
+}
+
+typedef struct {
+    SoftwareTimer_Manager * manager;
+    SoftwareTimer_Entry * entries;
+    SoftwareTimer_Entry * extra;
+    const SoftwareTimer_Entry * reported[32];
+    uint32_t count;
+} visit_changes;
+
+static bool visit_changing(const SoftwareTimer_EntryInfo * info, void * context)
+{
+    visit_changes * changes = (visit_changes *) context;
+
+    changes->reported[changes->count++] = info->entry;
+    if (info->entry == &changes->entries[2]) {
+        SoftwareTimer_ManagerStop(changes->manager, &changes->entries[12]);
+        SoftwareTimer_ManagerStart(changes->manager, changes->extra, 100);
+        SoftwareTimer_ManagerStart(changes->manager, &changes->entries[0], 500);
+    }
+    return changes->count < 32;
+}
+
+void test_SoftwareTimer_Manager_VisitResumesAfterChanges(void)
+{
+    static SoftwareTimer_Manager manager;
+    static SoftwareTimer_Entry entries[20];
+    static SoftwareTimer_Entry extra;
+    static visit_changes changes;
+    static const int id = 0;
+    static const int expected[21] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 14, -1, 15, 16, 17, 18, 19, 0};
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_EntryInit(&extra, record_callback, (void *) &id);
+    for (int i = 0; i < 20; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &id);
+        SoftwareTimer_ManagerStart(&manager, &entries[i], i < 5 ? 10u * (i + 1u) : i < 15 ? 100u : 200u + 10u * i);
+    }
+    changes.manager = &manager;
+    changes.entries = entries;
+    changes.extra = &extra;
+    changes.count = 0;
+
+    // The visitor runs outside the critical section and changes the list in
+    // the first batch; the walk resumes inside the run of equal deadlines
+    TEST_ASSERT_EQUAL(21, SoftwareTimer_ManagerVisit(&manager, visit_changing, &changes));
+    for (int i = 0; i < 21; i++) {
+        TEST_ASSERT_EQUAL_PTR(expected[i] < 0 ? &extra : &entries[expected[i]], changes.reported[i]);
+    }
+}
+
+void test_SoftwareTimer_Group_ExpiryAndScan(void)
+{
+    SoftwareTimer_GroupMember members[4];
+    SoftwareTimer_Group group;
+
+    TEST_ASSERT_EQUAL(4, sizeof(SoftwareTimer_GroupMember));
+    SoftwareTimer_GroupInit(&group, members, 4);
+    SoftwareTimer_GroupSet(&group, 1, 100);
+    advance_time(50);
+    SoftwareTimer_GroupSet(&group, 3, 30);
+    TEST_ASSERT_EQUAL(50, SoftwareTimer_GroupRemaining(&group, 1));
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_GROUP_NONE, SoftwareTimer_GroupNextExpired(&group, 0));
+
+    advance_time(50);
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 1));
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 3));
+    TEST_ASSERT_FALSE(SoftwareTimer_GroupIsExpired(&group, 0));
+    TEST_ASSERT_EQUAL(1, SoftwareTimer_GroupNextExpired(&group, 0));
+    TEST_ASSERT_EQUAL(3, SoftwareTimer_GroupNextExpired(&group, 2));
+
+    SoftwareTimer_GroupStop(&group, 1);
+    TEST_ASSERT_FALSE(SoftwareTimer_GroupIsExpired(&group, 1));
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_GroupRemaining(&group, 1));
+    TEST_ASSERT_EQUAL(3, SoftwareTimer_GroupNextExpired(&group, 0));
+}
+
+void test_SoftwareTimer_Group_LazyRebaseAcrossWrap(void)
+{
+    SoftwareTimer_GroupMember members[3];
+    SoftwareTimer_Group group;
+    mock_time = UINT32_MAX - 100000;
+
+    SoftwareTimer_GroupInit(&group, members, 3);
+    SoftwareTimer_GroupSet(&group, 0, 500); // will have expired at rebase time
+    advance_time(65000);
+    SoftwareTimer_GroupSet(&group, 1, 60000); // still running at rebase time
+    advance_time(40000);
+
+    // Offset from the old base exceeds 16 bits and the clock wrapped
+    SoftwareTimer_GroupSet(&group, 2, 1000);
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 0));
+    TEST_ASSERT_EQUAL(20000, SoftwareTimer_GroupRemaining(&group, 1));
+    TEST_ASSERT_EQUAL(1000, SoftwareTimer_GroupRemaining(&group, 2));
+
+    advance_time(20000);
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 1));
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 2));
+    TEST_ASSERT_TRUE(SoftwareTimer_GroupIsExpired(&group, 0));
+}
+
+void test_SoftwareTimer_Manager_PeriodicCatchUpSkipsMissedPeriods(void)
+{
+    static const int id = 3;
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry periodic;
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_EntryInit(&periodic, record_callback, (void *) &id);
+    SoftwareTimer_ManagerStartPeriodic(&manager, &periodic, 100);
+
+    // Clock jumps by 10000 periods: one callback, phase kept
+    advance_time(1000050);
+    TEST_ASSERT_EQUAL(50, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(9999, periodic.missed);
+
+    advance_time(50);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, fired_count);
+    TEST_ASSERT_EQUAL(0, periodic.missed);
+}
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+static void concurrent_callback(SoftwareTimer_Entry * entry)
+{
+    (*(int *) entry->context)++;
+}
+
+void test_SoftwareTimer_Concurrent_ArmCancelAndRearm(void)
+{
+    SoftwareTimer_Concurrent timers;
+    SoftwareTimer_ConcurrentEntry entries[3];
+    int fired[3] = {0, 0, 0};
+
+    SoftwareTimer_ConcurrentInit(&timers);
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_ConcurrentEntryInit(&entries[i], concurrent_callback, &fired[i]);
+    }
+
+    TEST_ASSERT_TRUE(SoftwareTimer_ConcurrentArm(&timers, &entries[0], 100));
+    TEST_ASSERT_FALSE(SoftwareTimer_ConcurrentArm(&timers, &entries[1], 100));
+    SoftwareTimer_ConcurrentArmPeriodic(&timers, &entries[2], 40);
+    SoftwareTimer_ConcurrentCancel(&timers, &entries[1]); // before it was applied
+    TEST_ASSERT_EQUAL(40, SoftwareTimer_ConcurrentProcess(&timers));
+
+    // Start time is taken by the arming thread, not when the request is applied
+    advance_time(50);
+    SoftwareTimer_ConcurrentArm(&timers, &entries[0], 100); // re-arm supersedes the first request
+    advance_time(50);
+    TEST_ASSERT_EQUAL(20, SoftwareTimer_ConcurrentProcess(&timers));
+    TEST_ASSERT_EQUAL(0, fired[0]);
+    TEST_ASSERT_EQUAL(0, fired[1]);
+    TEST_ASSERT_EQUAL(1, fired[2]); // two missed periods coalesced
+
+    SoftwareTimer_ConcurrentCancel(&timers, &entries[2]); // after it was applied
+    advance_time(50);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ConcurrentProcess(&timers));
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL(0, fired[1]);
+    TEST_ASSERT_EQUAL(1, fired[2]);
+}
+
+void test_SoftwareTimer_Concurrent_RequestBeingWrittenIsRetried(void)
+{
+    SoftwareTimer_Concurrent timers;
+    SoftwareTimer_ConcurrentEntry entry;
+    int fired = 0;
+
+    SoftwareTimer_ConcurrentInit(&timers);
+    SoftwareTimer_ConcurrentEntryInit(&entry, concurrent_callback, &fired);
+    TEST_ASSERT_TRUE(SoftwareTimer_ConcurrentArm(&timers, &entry, 100));
+
+    // A writer holds WRITING (bit 1 of the state word) while the stack is
+    // drained: the entry is pushed back and the writer will not wake anyone
+    atomic_fetch_or(&entry.state, 0x2u);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ConcurrentProcess(&timers));
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_ConcurrentProcess(&timers));
+    TEST_ASSERT_NOT_NULL(atomic_load(&timers.pending));
+
+    atomic_fetch_and(&entry.state, ~0x2u);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_ConcurrentProcess(&timers));
+    advance_time(100);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ConcurrentProcess(&timers));
+    TEST_ASSERT_EQUAL(1, fired);
+}
+
+    #if defined(__unix__) || defined(__APPLE__)
+        #define CONCURRENT_THREADS 4
+        #define CONCURRENT_ENTRIES 256
+
+typedef struct {
+    SoftwareTimer_Concurrent * timers;
+    SoftwareTimer_ConcurrentEntry * entries;
+} concurrent_arg;
+
+static void * concurrent_arming_thread(void * arg)
+{
+    concurrent_arg * work = (concurrent_arg *) arg;
+    for (int i = 0; i < CONCURRENT_ENTRIES; i++) {
+        SoftwareTimer_ConcurrentArm(work->timers, &work->entries[i], 0);
+    }
+    return NULL;
+}
+
+void test_SoftwareTimer_Concurrent_ArmFromManyThreads(void)
+{
+    static SoftwareTimer_Concurrent timers;
+    static SoftwareTimer_ConcurrentEntry entries[CONCURRENT_THREADS][CONCURRENT_ENTRIES];
+    static int fired[CONCURRENT_THREADS][CONCURRENT_ENTRIES];
+    pthread_t threads[CONCURRENT_THREADS];
+    concurrent_arg args[CONCURRENT_THREADS];
+    int total = 0;
+
+    SoftwareTimer_ConcurrentInit(&timers);
+    for (int t = 0; t < CONCURRENT_THREADS; t++) {
+        for (int i = 0; i < CONCURRENT_ENTRIES; i++) {
+            fired[t][i] = 0;
+            SoftwareTimer_ConcurrentEntryInit(&entries[t][i], concurrent_callback, &fired[t][i]);
+        }
+        args[t].timers = &timers;
+        args[t].entries = entries[t];
+        pthread_create(&threads[t], NULL, concurrent_arming_thread, &args[t]);
+    }
+
+    // Process while the threads are still arming
+    for (int round = 0; round < 100000 && total < CONCURRENT_THREADS * CONCURRENT_ENTRIES; round++) {
+        SoftwareTimer_ConcurrentProcess(&timers);
+        total = 0;
+        for (int t = 0; t < CONCURRENT_THREADS; t++) {
+            for (int i = 0; i < CONCURRENT_ENTRIES; i++) {
+                total += fired[t][i];
+            }
+        }
+    }
+    for (int t = 0; t < CONCURRENT_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    SoftwareTimer_ConcurrentProcess(&timers);
+
+    for (int t = 0; t < CONCURRENT_THREADS; t++) {
+        for (int i = 0; i < CONCURRENT_ENTRIES; i++) {
+            TEST_ASSERT_EQUAL(1, fired[t][i]);
+        }
+    }
+}
+typedef struct {
+    SoftwareTimer_Concurrent timers;
+    atomic_bool stop;
+    atomic_bool cancelling;
+    atomic_int started;
+    atomic_int finished;
+    atomic_int rounds;
+} concurrent_sync;
+
+static void concurrent_sync_wake(void * context)
+{
+    atomic_store(&((concurrent_sync *) context)->cancelling, true);
+}
+
+// Runs until the cancel request has been published, so it is still running
+// when the cancelling thread decides whether to wait
+static void concurrent_slow_callback(SoftwareTimer_Entry * entry)
+{
+    concurrent_sync * sync = (concurrent_sync *) entry->context;
+    atomic_fetch_add(&sync->started, 1);
+    while (!atomic_load(&sync->cancelling)) {
+    }
+    atomic_fetch_add(&sync->finished, 1);
+}
+
+static void * concurrent_processing_thread(void * arg)
+{
+    concurrent_sync * sync = (concurrent_sync *) arg;
+    while (!atomic_load(&sync->stop)) {
+        SoftwareTimer_ConcurrentProcess(&sync->timers);
+        atomic_fetch_add(&sync->rounds, 1);
+    }
+    return NULL;
+}
+
+void test_SoftwareTimer_Concurrent_CancelSync(void)
+{
+    static concurrent_sync sync;
+    SoftwareTimer_ConcurrentEntry entry;
+    pthread_t thread;
+
+    SoftwareTimer_ConcurrentInit(&sync.timers);
+    SoftwareTimer_ConcurrentSetWake(&sync.timers, concurrent_sync_wake, &sync);
+    atomic_init(&sync.stop, false);
+    atomic_init(&sync.cancelling, false);
+    atomic_init(&sync.started, 0);
+    atomic_init(&sync.finished, 0);
+    atomic_init(&sync.rounds, 0);
+    SoftwareTimer_ConcurrentEntryInit(&entry, concurrent_slow_callback, &sync);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_INACTIVE, SoftwareTimer_ConcurrentCancelSync(&sync.timers, &entry));
+    pthread_create(&thread, NULL, concurrent_processing_thread, &sync);
+
+    // Pending expiration is prevented
+    SoftwareTimer_ConcurrentArm(&sync.timers, &entry, 1000);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_PREVENTED, SoftwareTimer_ConcurrentCancelSync(&sync.timers, &entry));
+    TEST_ASSERT_EQUAL(0, atomic_load(&sync.started));
+
+    // Running callback is waited for
+    atomic_store(&sync.cancelling, false);
+    SoftwareTimer_ConcurrentArm(&sync.timers, &entry, 0);
+    while (atomic_load(&sync.started) == 0) {
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_WAITED, SoftwareTimer_ConcurrentCancelSync(&sync.timers, &entry));
+    TEST_ASSERT_EQUAL(1, atomic_load(&sync.finished));
+
+    // Callback that already ran: two full rounds after it returned, the
+    // processing thread has released the entry
+    SoftwareTimer_ConcurrentArm(&sync.timers, &entry, 0);
+    while (atomic_load(&sync.finished) < 2) {
+    }
+    int rounds = atomic_load(&sync.rounds);
+    while (atomic_load(&sync.rounds) < rounds + 2) {
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_INACTIVE, SoftwareTimer_ConcurrentCancelSync(&sync.timers, &entry));
+
+    atomic_store(&sync.stop, true);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL(2, atomic_load(&sync.started));
+}
+
+typedef struct {
+    SoftwareTimer_Concurrent timers;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int wakes;
+    bool stop;
+} concurrent_sleeper;
+
+static void concurrent_wake(void * context)
+{
+    concurrent_sleeper * sleeper = (concurrent_sleeper *) context;
+    pthread_mutex_lock(&sleeper->mutex);
+    sleeper->wakes++;
+    pthread_cond_signal(&sleeper->cond);
+    pthread_mutex_unlock(&sleeper->mutex);
+}
+
+static void * concurrent_sleeping_thread(void * arg)
+{
+    concurrent_sleeper * sleeper = (concurrent_sleeper *) arg;
+    pthread_mutex_lock(&sleeper->mutex);
+    while (!sleeper->stop) {
+        // Sleeps without timeout on NO_DEADLINE, so only a wake gets it going
+        while (sleeper->wakes == 0 && !sleeper->stop) {
+            pthread_cond_wait(&sleeper->cond, &sleeper->mutex);
+        }
+        sleeper->wakes = 0;
+        pthread_mutex_unlock(&sleeper->mutex);
+        while (SoftwareTimer_ConcurrentProcess(&sleeper->timers) == 0) {
+        }
+        pthread_mutex_lock(&sleeper->mutex);
+    }
+    pthread_mutex_unlock(&sleeper->mutex);
+    return NULL;
+}
+
+void test_SoftwareTimer_Concurrent_CancelSyncWakesSleepingThread(void)
+{
+    static concurrent_sleeper sleeper;
+    SoftwareTimer_ConcurrentEntry entries[2];
+    int fired[2] = {0, 0};
+    pthread_t thread;
+
+    SoftwareTimer_ConcurrentInit(&sleeper.timers);
+    SoftwareTimer_ConcurrentSetWake(&sleeper.timers, concurrent_wake, &sleeper);
+    pthread_mutex_init(&sleeper.mutex, NULL);
+    pthread_cond_init(&sleeper.cond, NULL);
+    sleeper.wakes = 0;
+    sleeper.stop = false;
+    pthread_create(&thread, NULL, concurrent_sleeping_thread, &sleeper);
+
+    // Requests are left on the stack without a wake; the cancelled entry is
+    // not first on the stack, yet the sleeping thread must be woken
+    for (int i = 0; i < 2; i++) {
+        SoftwareTimer_ConcurrentEntryInit(&entries[i], concurrent_callback, &fired[i]);
+        SoftwareTimer_ConcurrentArm(&sleeper.timers, &entries[i], 1000);
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_PREVENTED, SoftwareTimer_ConcurrentCancelSync(&sleeper.timers, &entries[0]));
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_PREVENTED, SoftwareTimer_ConcurrentCancelSync(&sleeper.timers, &entries[1]));
+
+    // Cancel of an applied entry, with the processing thread asleep
+    SoftwareTimer_ConcurrentArm(&sleeper.timers, &entries[0], 1000);
+    concurrent_wake(&sleeper);
+    while ((atomic_load(&entries[0].state) & 0x1u) != 0) {
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_CANCEL_PREVENTED, SoftwareTimer_ConcurrentCancelSync(&sleeper.timers, &entries[0]));
+
+    pthread_mutex_lock(&sleeper.mutex);
+    sleeper.stop = true;
+    pthread_cond_signal(&sleeper.cond);
+    pthread_mutex_unlock(&sleeper.mutex);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL(0, fired[0]);
+    TEST_ASSERT_EQUAL(0, fired[1]);
+}
+    #endif
+#endif
+
+#if defined(SOFTWARETIMER_CRITICAL) && (defined(__unix__) || defined(__APPLE__)) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_ATOMICS__)
+    #define CRITICAL_THREADS 4
+    #define CRITICAL_ENTRIES 64
+    #define CRITICAL_ROUNDS 20000
+
+typedef struct {
+    SoftwareTimer_Manager * manager;
+    SoftwareTimer_Entry * entries;
+    atomic_bool * stop;
+} critical_arg;
+
+static atomic_int critical_fired;
+
+static void critical_callback(SoftwareTimer_Entry * entry)
+{
+    (void) entry;
+    atomic_fetch_add(&critical_fired, 1);
+}
+
+static void * critical_arming_thread(void * arg)
+{
+    critical_arg * work = (critical_arg *) arg;
+    for (int round = 0; round < CRITICAL_ROUNDS; round++) {
+        SoftwareTimer_Entry * entry = &work->entries[(round * 7) % CRITICAL_ENTRIES];
+        switch (round % 3) {
+            case 0:
+                SoftwareTimer_ManagerStart(work->manager, entry, 0);
+                break;
+            case 1:
+                SoftwareTimer_ManagerStartPeriodic(work->manager, entry, 1 + (uint32_t) round % 7u);
+                break;
+            default:
+                SoftwareTimer_ManagerStop(work->manager, entry);
+                break;
+        }
+    }
+    return NULL;
+}
+
+static void * critical_processing_thread(void * arg)
+{
+    critical_arg * work = (critical_arg *) arg;
+    while (!atomic_load(work->stop)) {
+        SoftwareTimer_ManagerProcess(work->manager);
+    }
+    return NULL;
+}
+
+static bool critical_visit(const SoftwareTimer_EntryInfo * info, void * context)
+{
+    TEST_ASSERT_TRUE(info->remaining <= 7);
+    (*(uint32_t *) context)++;
+    return true;
+}
+
+void test_SoftwareTimer_Manager_ArmAndStopFromManyThreads(void)
+{
+    static SoftwareTimer_Manager manager;
+    static SoftwareTimer_Entry entries[CRITICAL_THREADS][CRITICAL_ENTRIES];
+    static atomic_bool stop;
+    pthread_t arming[CRITICAL_THREADS];
+    pthread_t processing;
+    critical_arg args[CRITICAL_THREADS + 1];
+
+    SoftwareTimer_ManagerInit(&manager);
+    atomic_init(&stop, false);
+    atomic_init(&critical_fired, 0);
+    args[CRITICAL_THREADS].manager = &manager;
+    args[CRITICAL_THREADS].stop = &stop;
+    pthread_create(&processing, NULL, critical_processing_thread, &args[CRITICAL_THREADS]);
+    for (int t = 0; t < CRITICAL_THREADS; t++) {
+        for (int i = 0; i < CRITICAL_ENTRIES; i++) {
+            SoftwareTimer_EntryInit(&entries[t][i], critical_callback, NULL);
+        }
+        args[t].manager = &manager;
+        args[t].entries = entries[t];
+        pthread_create(&arming[t], NULL, critical_arming_thread, &args[t]);
+    }
+
+    // Debug walks from yet another thread while the list changes
+    for (int i = 0; i < 200; i++) {
+        uint32_t visited = 0;
+        TEST_ASSERT_EQUAL(SoftwareTimer_ManagerVisit(&manager, critical_visit, &visited), visited);
+        TEST_ASSERT_TRUE(visited <= CRITICAL_THREADS * CRITICAL_ENTRIES);
+    }
+
+    for (int t = 0; t < CRITICAL_THREADS; t++) {
+        pthread_join(arming[t], NULL);
+    }
+    atomic_store(&stop, true);
+    pthread_join(processing, NULL);
+    TEST_ASSERT_GREATER_THAN(0, atomic_load(&critical_fired));
+
+    // The list is intact: linked both ways, sorted and holding only armed entries
+    uint32_t linked = 0;
+    for (const SoftwareTimer_Entry * entry = manager.head; entry != NULL; entry = entry->next) {
+        TEST_ASSERT_TRUE(SoftwareTimer_EntryIsActive(entry));
+        if (entry->next != NULL) {
+            TEST_ASSERT_EQUAL_PTR(entry, entry->next->prev);
+            TEST_ASSERT_TRUE((int32_t) (entry->next->timer.start + entry->next->timer.interval - entry->timer.start - entry->timer.interval) >= 0);
+        }
+        linked++;
+    }
+    uint32_t armed = 0;
+    for (int t = 0; t < CRITICAL_THREADS; t++) {
+        for (int i = 0; i < CRITICAL_ENTRIES; i++) {
+            armed += SoftwareTimer_EntryIsActive(&entries[t][i]) ? 1u : 0u;
+            SoftwareTimer_ManagerStop(&manager, &entries[t][i]);
+        }
+    }
+    TEST_ASSERT_EQUAL(armed, linked);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+    #ifdef SOFTWARETIMER_STATS
+    TEST_ASSERT_EQUAL(0, manager.stats.active);
+    #endif
+}
+#endif
+
+void test_SoftwareTimer_Pll_LocksToDriftingReference(void)
+{
+    SoftwareTimer_Pll pll;
+    uint32_t pulse = 3;
+    uint32_t lastExpiration = 0;
+    int expirations = 0;
+
+    // Nominal 10 ticks, but the reference runs 1% slow against the local clock
+    SoftwareTimer_PllInit(&pll, SOFTWARETIMER_PLL_PERIOD(10u, 1u));
+    TEST_ASSERT_FALSE(SoftwareTimer_PllIsLocked(&pll));
+
+    for (int pulses = 0; pulses < 60;) {
+        advance_time(1);
+        uint32_t now = SoftwareTimer_Now();
+        if (SoftwareTimer_PllIsExpired(&pll)) {
+            lastExpiration = now;
+            expirations++;
+        }
+        if (now == pulse) {
+            SoftwareTimer_PllSync(&pll, now);
+            pulse += 101;
+            pulses++;
+            if (pulses > 40) {
+                // Expirations coincide with the pulse within one tick
+                uint32_t offset = SoftwareTimer_PllRemaining(&pll) < now - lastExpiration ? SoftwareTimer_PllRemaining(&pll) : now - lastExpiration;
+                TEST_ASSERT_TRUE(offset <= 1);
+                TEST_ASSERT_TRUE(SoftwareTimer_PllIsLocked(&pll));
+            }
+        }
+    }
+    // Period converged to 10.1 ticks
+    TEST_ASSERT_TRUE(pll.correction > 6554 - 1000 && pll.correction < 6554 + 1000);
+    TEST_ASSERT_TRUE(expirations > 580 && expirations < 600);
+}
+
+void test_SoftwareTimer_Manager_SoftEntriesAlignToGrid(void)
+{
+    static const int ids[4] = {0, 1, 2, 3};
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[4];
+    fired_count = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_ManagerSetGrid(&manager, 16);
+    for (int i = 0; i < 4; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &ids[i]);
+        SoftwareTimer_EntrySetSoft(&entries[i], i != 2);
+    }
+    advance_time((0u - SoftwareTimer_Now()) & 15u); // start on a grid point
+
+    // Hard entry keeps its deadline, soft entries wait for the grid point
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 3);
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 10);
+    SoftwareTimer_ManagerStart(&manager, &entries[2], 5);
+    TEST_ASSERT_EQUAL(5, SoftwareTimer_ManagerNextDeadline(&manager));
+    advance_time(5);
+    TEST_ASSERT_EQUAL(11, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    advance_time(11);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(3, fired_count);
+    TEST_ASSERT_EQUAL(0, fired_order[1]);
+    TEST_ASSERT_EQUAL(1, fired_order[2]);
+
+    // Periodic soft entry coalesces periods shorter than the grid, without drift
+    SoftwareTimer_ManagerStartPeriodic(&manager, &entries[3], 5);
+    TEST_ASSERT_EQUAL(16, SoftwareTimer_ManagerNextDeadline(&manager));
+    advance_time(16);
+    TEST_ASSERT_EQUAL(16, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(2, entries[3].missed);
+
+    // Switching the grid off applies to the next deadline
+    SoftwareTimer_ManagerSetGrid(&manager, 0);
+    advance_time(16);
+    TEST_ASSERT_EQUAL(3, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(5, fired_count);
+    SoftwareTimer_ManagerStop(&manager, &entries[3]);
+
+    // Longest soft interval of the widest grid is aligned to exactly INT32_MAX
+    // ticks and still orders before a later hard deadline
+    SoftwareTimer_ManagerSetGrid(&manager, 1u << 30);
+    advance_time((1u - SoftwareTimer_Now()) & ((1u << 30) - 1u));
+    SoftwareTimer_ManagerStart(&manager, &entries[1], (uint32_t) INT32_MAX - ((1u << 30) - 1u));
+    SoftwareTimer_ManagerStart(&manager, &entries[2], INT32_MAX);
+    TEST_ASSERT_EQUAL(INT32_MAX, SoftwareTimer_ManagerNextDeadline(&manager));
+    TEST_ASSERT_EQUAL_PTR(&entries[1], manager.head);
+    advance_time(INT32_MAX);
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerProcess(&manager));
+    TEST_ASSERT_EQUAL(7, fired_count);
+    TEST_ASSERT_EQUAL(1, fired_order[5]);
+    TEST_ASSERT_EQUAL(2, fired_order[6]);
+}
+
+static int cyclic_runs[3];
+static uint32_t cyclic_busy;
+
+static void cyclic_task(void * context)
+{
+    cyclic_runs[*(const int *) context]++;
+    advance_time(cyclic_busy);
+}
+
+void test_SoftwareTimer_Cyclic_FrameTableAndOverrun(void)
+{
+    static const int ids[3] = {0, 1, 2};
+    const SoftwareTimer_CyclicTask tasks[3] = {
+        {cyclic_task, (void *) &ids[0], 1, 0},
+        {cyclic_task, (void *) &ids[1], 2, 1},
+        {cyclic_task, (void *) &ids[2], 4, 3},
+    };
+    const SoftwareTimer_CyclicTask invalid[2] = {
+        {cyclic_task, NULL, 2, 0},
+        {cyclic_task, NULL, 3, 0},
+    };
+    uint32_t frames[4];
+    SoftwareTimer_Cyclic cyclic;
+    cyclic_runs[0] = cyclic_runs[1] = cyclic_runs[2] = 0;
+    cyclic_busy = 0;
+
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_CyclicBuild(invalid, 2, frames, 4)); // not harmonic
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_CyclicBuild(tasks, 3, frames, 3)); // does not fit
+    TEST_ASSERT_EQUAL(4, SoftwareTimer_CyclicBuild(tasks, 3, frames, 4));
+    TEST_ASSERT_EQUAL(0x1, frames[0]);
+    TEST_ASSERT_EQUAL(0x3, frames[1]);
+    TEST_ASSERT_EQUAL(0x1, frames[2]);
+    TEST_ASSERT_EQUAL(0x7, frames[3]);
+
+    // Two major frames on a 10-tick grid
+    SoftwareTimer_CyclicStart(&cyclic, tasks, frames, 4, 10);
+    TEST_ASSERT_EQUAL(10, SoftwareTimer_CyclicPoll(&cyclic));
+    TEST_ASSERT_EQUAL(10, SoftwareTimer_CyclicPoll(&cyclic)); // frame 1 not due yet
+    TEST_ASSERT_EQUAL(1, cyclic_runs[0]);
+    for (int i = 1; i < 8; i++) {
+        advance_time(10);
+        TEST_ASSERT_EQUAL(10, SoftwareTimer_CyclicPoll(&cyclic));
+    }
+    TEST_ASSERT_EQUAL(8, cyclic_runs[0]);
+    TEST_ASSERT_EQUAL(4, cyclic_runs[1]);
+    TEST_ASSERT_EQUAL(2, cyclic_runs[2]);
+    TEST_ASSERT_EQUAL(0, cyclic.overruns);
+
+    // Frame 0 runs into frame 1; frame 1 starts late but the grid is kept
+    advance_time(10);
+    cyclic_busy = 12;
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_CyclicPoll(&cyclic));
+    TEST_ASSERT_EQUAL(1, cyclic.overruns);
+    TEST_ASSERT_EQUAL(0, cyclic.lastOverrun);
+    cyclic_busy = 0;
+    TEST_ASSERT_EQUAL(8, SoftwareTimer_CyclicPoll(&cyclic));
+    TEST_ASSERT_EQUAL(1, cyclic.overruns);
+}
+
+static int broadcast_calls[4];
+static SoftwareTimer_Broadcast * broadcast_target;
+static SoftwareTimer_Subscriber * broadcast_late;
+
+static void broadcast_callback(SoftwareTimer_Subscriber * subscriber)
+{
+    int id = *(const int *) subscriber->context;
+    broadcast_calls[id]++;
+    if (id == 0 && broadcast_calls[0] == 2) {
+        SoftwareTimer_BroadcastUnsubscribe(subscriber);
+        SoftwareTimer_BroadcastSubscribe(broadcast_target, broadcast_late);
+    }
+}
+
+void test_SoftwareTimer_Broadcast_FansOutFromOneEntry(void)
+{
+    static const int ids[4] = {0, 1, 2, 3};
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Broadcast broadcast;
+    SoftwareTimer_Subscriber subscribers[4];
+
+    SoftwareTimer_ManagerInit(&manager);
+    SoftwareTimer_BroadcastInit(&broadcast, &manager, 100);
+    for (int i = 0; i < 4; i++) {
+        broadcast_calls[i] = 0;
+        SoftwareTimer_SubscriberInit(&subscribers[i], broadcast_callback, (void *) &ids[i]);
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_BroadcastSubscribe(&broadcast, &subscribers[i]);
+        advance_time(10); // late subscribers share the phase
+    }
+    TEST_ASSERT_TRUE(manager.head->next == NULL); // one manager entry
+    TEST_ASSERT_EQUAL(70, SoftwareTimer_ManagerNextDeadline(&manager));
+
+    advance_time(70);
+    SoftwareTimer_ManagerProcess(&manager);
+    TEST_ASSERT_EQUAL(1, broadcast_calls[0]);
+    TEST_ASSERT_EQUAL(1, broadcast_calls[1]);
+    TEST_ASSERT_EQUAL(1, broadcast_calls[2]);
+
+    // Subscriber 0 leaves and adds subscriber 3 during the notification
+    broadcast_target = &broadcast;
+    broadcast_late = &subscribers[3];
+    advance_time(100);
+    SoftwareTimer_ManagerProcess(&manager);
+    advance_time(100);
+    SoftwareTimer_ManagerProcess(&manager);
+    TEST_ASSERT_EQUAL(2, broadcast_calls[0]);
+    TEST_ASSERT_EQUAL(3, broadcast_calls[1]);
+    TEST_ASSERT_EQUAL(3, broadcast_calls[2]);
+    TEST_ASSERT_EQUAL(1, broadcast_calls[3]);
+
+    for (int i = 1; i < 4; i++) {
+        SoftwareTimer_BroadcastUnsubscribe(&subscribers[i]);
+    }
+    TEST_ASSERT_EQUAL(SOFTWARETIMER_NO_DEADLINE, SoftwareTimer_ManagerNextDeadline(&manager));
+}
+
+#if defined(SOFTWARETIMER_IOURING) && defined(__linux__)
+    #define URING_TAG 0x100u
+
+static int uring_init_result;
+static int uring_exits;
+
+int io_uring_queue_init(unsigned entries, struct io_uring * ring, unsigned flags)
+{
+    (void) entries;
+    (void) flags;
+    memset(ring, 0, sizeof(*ring));
+    return uring_init_result;
+}
+
+void io_uring_queue_exit(struct io_uring * ring)
+{
+    (void) ring;
+    uring_exits++;
+}
+
+void test_SoftwareTimer_Uring_TimeoutLifecycle(void)
+{
+    static const int ids[2] = {0, 1};
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[2];
+    SoftwareTimer_Uring uring;
+    struct io_uring_cqe cqe = {0};
+    struct timespec now;
+    fired_count = 0;
+    uring_init_result = 0;
+    uring_exits = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    for (int i = 0; i < 2; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &ids[i]);
+    }
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringInit(&uring, &manager, 8, URING_TAG));
+    TEST_ASSERT_EQUAL(-1, uring.timerfd);
+
+    // Nothing armed: no request
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(0, uring.ring.queued);
+
+    // First deadline: absolute timeout
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 500);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(1, uring.ring.queued);
+    TEST_ASSERT_EQUAL(IORING_OP_TIMEOUT, uring.ring.sq[0].opcode);
+    TEST_ASSERT_EQUAL(IORING_TIMEOUT_ABS, uring.ring.sq[0].timeout_flags);
+    TEST_ASSERT_EQUAL(0, uring.ring.sq[0].off);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].addr == (uint64_t) (uintptr_t) &uring.timeout);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].user_data == URING_TAG + 1u);
+    int64_t delta = (uring.timeout.tv_sec - now.tv_sec) * 1000000000 + (uring.timeout.tv_nsec - now.tv_nsec);
+    TEST_ASSERT_TRUE(delta >= 500000000LL && delta < 600000000LL);
+    io_uring_submit(&uring.ring);
+
+    // Unchanged list: the pending timeout is kept
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(0, uring.ring.queued);
+
+    // Earlier deadline: the pending timeout is updated
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 100);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(1, uring.ring.queued);
+    TEST_ASSERT_EQUAL(IORING_OP_TIMEOUT_REMOVE, uring.ring.sq[0].opcode);
+    TEST_ASSERT_EQUAL(IORING_TIMEOUT_ABS | IORING_TIMEOUT_UPDATE, uring.ring.sq[0].timeout_flags);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].addr == URING_TAG + 1u);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].off == (uint64_t) (uintptr_t) &uring.timeout);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].user_data == URING_TAG);
+    io_uring_submit(&uring.ring);
+
+    // Update completion and foreign completions process nothing
+    cqe.user_data = URING_TAG;
+    TEST_ASSERT_TRUE(SoftwareTimer_UringHandleCqe(&uring, &cqe));
+    cqe.user_data = 7;
+    TEST_ASSERT_FALSE(SoftwareTimer_UringHandleCqe(&uring, &cqe));
+    cqe.user_data = (uint64_t) URING_TAG + UINT32_MAX + 1u;
+    TEST_ASSERT_FALSE(SoftwareTimer_UringHandleCqe(&uring, &cqe));
+    TEST_ASSERT_EQUAL(0, fired_count);
+
+    // Expiration processes the manager; the next rearm adds a new timeout
+    advance_time(100);
+    cqe.user_data = URING_TAG + 1u;
+    cqe.res = -ETIME;
+    TEST_ASSERT_TRUE(SoftwareTimer_UringHandleCqe(&uring, &cqe));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(1, fired_order[0]);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(1, uring.ring.queued);
+    TEST_ASSERT_EQUAL(IORING_OP_TIMEOUT, uring.ring.sq[0].opcode);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].user_data == URING_TAG + 2u);
+    io_uring_submit(&uring.ring);
+
+    // Late completion of an earlier timeout leaves the current one armed
+    cqe.res = -ECANCELED;
+    TEST_ASSERT_TRUE(SoftwareTimer_UringHandleCqe(&uring, &cqe));
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(0, uring.ring.queued);
+
+    // No entry left: the timeout is removed, once
+    SoftwareTimer_ManagerStop(&manager, &entries[0]);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(1, uring.ring.queued);
+    TEST_ASSERT_EQUAL(IORING_OP_TIMEOUT_REMOVE, uring.ring.sq[0].opcode);
+    TEST_ASSERT_EQUAL(0, uring.ring.sq[0].timeout_flags);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].addr == URING_TAG + 2u);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].user_data == URING_TAG);
+    io_uring_submit(&uring.ring);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(0, uring.ring.queued);
+
+    // Full submission queue is submitted to make room
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 50);
+    io_uring_get_sqe(&uring.ring);
+    io_uring_get_sqe(&uring.ring);
+    unsigned submits = uring.ring.submits;
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(submits + 1, uring.ring.submits);
+    TEST_ASSERT_EQUAL(1, uring.ring.queued);
+    TEST_ASSERT_TRUE(uring.ring.sq[0].user_data == URING_TAG + 3u);
+
+    SoftwareTimer_UringExit(&uring);
+    TEST_ASSERT_EQUAL(1, uring_exits);
+}
+
+void test_SoftwareTimer_Uring_FallsBackToTimerfd(void)
+{
+    static const int ids[2] = {0, 1};
+    SoftwareTimer_Manager manager;
+    SoftwareTimer_Entry entries[2];
+    SoftwareTimer_Uring uring;
+    fired_count = 0;
+    uring_init_result = -ENOSYS;
+    uring_exits = 0;
+
+    SoftwareTimer_ManagerInit(&manager);
+    for (int i = 0; i < 2; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &ids[i]);
+    }
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringInit(&uring, &manager, 8, URING_TAG));
+    TEST_ASSERT_TRUE(uring.timerfd >= 0);
+
+    // Deadline programs the timerfd, stopping the entry disarms it
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 2000);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_TRUE(timerfd_left_ns(uring.timerfd) > 1900000000LL);
+    TEST_ASSERT_FALSE(SoftwareTimer_UringHandleTimerfd(&uring));
+    SoftwareTimer_ManagerStop(&manager, &entries[0]);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_EQUAL(0, timerfd_left_ns(uring.timerfd));
+
+    // Due entry: readable at once and processed
+    SoftwareTimer_ManagerStart(&manager, &entries[0], 2000);
+    SoftwareTimer_ManagerStart(&manager, &entries[1], 0);
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    struct pollfd pfd = {.fd = uring.timerfd, .events = POLLIN};
+    TEST_ASSERT_EQUAL(1, poll(&pfd, 1, 1000));
+    TEST_ASSERT_TRUE(SoftwareTimer_UringHandleTimerfd(&uring));
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(1, fired_order[0]);
+
+    // The next rearm programs the remaining entry again
+    TEST_ASSERT_EQUAL(0, SoftwareTimer_UringRearm(&uring));
+    TEST_ASSERT_TRUE(timerfd_left_ns(uring.timerfd) > 1900000000LL);
+
+    SoftwareTimer_UringExit(&uring);
+    TEST_ASSERT_EQUAL(0, uring_exits);
+    TEST_ASSERT_EQUAL(-1, uring.timerfd);
+}
+#endif
+
+#ifdef SOFTWARETIMER_FREERTOS
+static uint32_t freertos_notifications;
+static TaskHandle_t freertos_notified;
+static int freertos_critical_depth;
+static int freertos_critical_sections;
+static jmp_buf freertos_task_exit;
+
+TickType_t xTaskGetTickCount(void)
+{
+    return mock_time;
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    TEST_ASSERT_EQUAL(1, freertos_critical_depth);
+    return mock_time;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t * higherPriorityTaskWoken)
+{
+    (void) higherPriorityTaskWoken;
+    TEST_ASSERT_EQUAL(0, freertos_critical_depth);
+    freertos_notified = task;
+    freertos_notifications++;
+}
+
+// Returns to the test instead of blocking when no notification is pending
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+    TEST_ASSERT_EQUAL(portMAX_DELAY, ticksToWait);
+    uint32_t count = freertos_notifications;
+    if (count == 0)
+        longjmp(freertos_task_exit, 1);
+    freertos_notifications = clearCountOnExit == pdTRUE ? 0 : count - 1;
+    return count;
+}
+
+void vTaskEnterCritical(void)
+{
+    freertos_critical_depth++;
+    freertos_critical_sections++;
+}
+
+void vTaskExitCritical(void)
+{
+    freertos_critical_depth--;
+}
+
+UBaseType_t uxTaskEnterCriticalFromISR(void)
+{
+    vTaskEnterCritical();
+    return 0x5A;
+}
+
+void vTaskExitCriticalFromISR(UBaseType_t state)
+{
+    TEST_ASSERT_EQUAL(0x5A, state);
+    vTaskExitCritical();
+}
+
+void test_SoftwareTimer_FreeRtos_TickHookIdleAndTaskLoop(void)
+{
+    static const int ids[3] = {0, 1, 2};
+    static int task;
+    SoftwareTimer_Entry entries[3];
+    fired_count = 0;
+    freertos_notifications = 0;
+    freertos_notified = NULL;
+    freertos_critical_depth = 0;
+    mock_time = 1000;
+
+    SoftwareTimer_FreeRtosInit();
+    TEST_ASSERT_EQUAL(1000, SoftwareTimer_Now()); // tick count is the clock
+    for (int i = 0; i < 3; i++) {
+        SoftwareTimer_EntryInit(&entries[i], record_callback, (void *) &ids[i]);
+    }
+
+    // Without a processing task nothing is notified
+    SoftwareTimer_FreeRtosStart(&entries[0], 0);
+    SoftwareTimer_FreeRtosTickHook();
+    TEST_ASSERT_EQUAL(0, freertos_notifications);
+    SoftwareTimer_FreeRtosStop(&entries[0]);
+    SoftwareTimer_FreeRtosSetTask((TaskHandle_t) &task);
+
+    // Expected idle time is clamped to the earliest deadline
+    TEST_ASSERT_EQUAL(500, SoftwareTimer_FreeRtosExpectedIdle(500));
+    SoftwareTimer_FreeRtosStart(&entries[0], 300);
+    SoftwareTimer_FreeRtosStartPeriodic(&entries[1], 100);
+    SoftwareTimer_FreeRtosStart(&entries[2], 200);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_FreeRtosExpectedIdle(500));
+    TEST_ASSERT_EQUAL(40, SoftwareTimer_FreeRtosExpectedIdle(40));
+    advance_time(60);
+    TEST_ASSERT_EQUAL(40, SoftwareTimer_FreeRtosExpectedIdle(500));
+
+    // Tick hook notifies only once the head is due, inside a critical section
+    freertos_critical_sections = 0;
+    SoftwareTimer_FreeRtosTickHook();
+    TEST_ASSERT_EQUAL(1, freertos_critical_sections);
+    TEST_ASSERT_EQUAL(0, freertos_notifications);
+    advance_time(40);
+    SoftwareTimer_FreeRtosTickHook();
+    TEST_ASSERT_EQUAL(1, freertos_notifications);
+    TEST_ASSERT_EQUAL_PTR(&task, freertos_notified);
+    TEST_ASSERT_EQUAL(0, freertos_critical_depth);
+
+    // Task loop pops every expired entry, periodic one re-armed
+    advance_time(100);
+    if (setjmp(freertos_task_exit) == 0) {
+        SoftwareTimer_FreeRtosTaskLoop();
+    }
+    TEST_ASSERT_EQUAL(2, fired_count);
+    TEST_ASSERT_EQUAL(1, fired_order[0]);
+    TEST_ASSERT_EQUAL(2, fired_order[1]);
+    TEST_ASSERT_EQUAL(0, freertos_critical_depth);
+    TEST_ASSERT_EQUAL(100, SoftwareTimer_FreeRtosExpectedIdle(500));
+
+    SoftwareTimer_FreeRtosStop(&entries[0]);
+    SoftwareTimer_FreeRtosStop(&entries[1]);
+    TEST_ASSERT_EQUAL(500, SoftwareTimer_FreeRtosExpectedIdle(500));
+}
+#endif
+
 void setUp(void)
 {
     // Reset test environment before each test
@@ -416,6 +2609,79 @@ int runUnityTests(void)
     RUN_TEST(test_SoftwareTimer_LargeInterval);
     RUN_TEST(test_SoftwareTimer_ConsecutiveOperations);
     RUN_TEST(test_SoftwareTimer_StateConsistency);
+    RUN_TEST(test_SoftwareTimer_Repeating_FiresExactCount);
+    RUN_TEST(test_SoftwareTimer_Repeating_NoDrift);
+    RUN_TEST(test_SoftwareTimer_Repeating_CatchUpAndOverflow);
+    RUN_TEST(test_SoftwareTimer_Repeating_ZeroCount);
+    RUN_TEST(test_SoftwareTimer_Window_CountsWithinWindow);
+    RUN_TEST(test_SoftwareTimer_Window_LongIdleAndOverflow);
+    RUN_TEST(test_SoftwareTimer_Manager_FiresInDeadlineOrder);
+    RUN_TEST(test_SoftwareTimer_Manager_PeriodicAndStop);
+    RUN_TEST(test_SoftwareTimer_Manager_RepeatingStopsAfterCount);
+    RUN_TEST(test_SoftwareTimer_Scheduler_DelayAndWait);
+    RUN_TEST(test_SoftwareTimer_Edf_RunsEarliestDeadlineFirst);
+    RUN_TEST(test_SoftwareTimer_Edf_AdmissionControl);
+#if defined(__unix__) || defined(__APPLE__)
+    RUN_TEST(test_SoftwareTimer_Posix_ToTimespec);
+    RUN_TEST(test_SoftwareTimer_Posix_PollExpired);
+    RUN_TEST(test_SoftwareTimer_Posix_ManagerNextTimespec);
+    RUN_TEST(test_SoftwareTimer_Posix_SleepUntilNeverEarly);
+#endif
+#ifdef __linux__
+    RUN_TEST(test_SoftwareTimer_Posix_TimerfdArm);
+#endif
+#if defined(__unix__)
+    RUN_TEST(test_SoftwareTimer_Service_DispatchesToWorkers);
+    RUN_TEST(test_SoftwareTimer_Service_DropDiscardsWhenFull);
+    RUN_TEST(test_SoftwareTimer_Service_CoalesceMergesQueuedEntry);
+    RUN_TEST(test_SoftwareTimer_Service_BlockLosesNoExpiration);
+#endif
+    RUN_TEST(test_SoftwareTimer_SuspendResume_RebasesAcrossSleep);
+    RUN_TEST(test_SoftwareTimer_Context_ChildBoundedByParent);
+    RUN_TEST(test_SoftwareTimer_Context_CascadingCancel);
+    RUN_TEST(test_SoftwareTimer_Units_ConstantConversion);
+    RUN_TEST(test_SoftwareTimer_Units_RuntimeConversion);
+    RUN_TEST(test_SoftwareTimer_Fsm_ManagerRearmsOnStateEntry);
+    RUN_TEST(test_SoftwareTimer_Fsm_QueuesShareOneManagerEntryPerState);
+    RUN_TEST(test_SoftwareTimer_Fsm_PollingWithoutManager);
+    RUN_TEST(test_SoftwareTimer_Watchdog_ReportsStarvedTask);
+#ifdef SOFTWARETIMER_STATS
+    RUN_TEST(test_SoftwareTimer_Manager_ProcessClampsDueEntryToZero);
+    RUN_TEST(test_SoftwareTimer_Metrics_ManagerCounters);
+    RUN_TEST(test_SoftwareTimer_Metrics_Formatters);
+    #if defined(__unix__) || defined(__APPLE__)
+    RUN_TEST(test_SoftwareTimer_Metrics_SnapshotFromAnotherThread);
+    #endif
+#endif
+    RUN_TEST(test_SoftwareTimer_Manager_VisitInDeadlineOrder);
+    RUN_TEST(test_SoftwareTimer_Manager_VisitResumesAfterChanges);
+    RUN_TEST(test_SoftwareTimer_Group_ExpiryAndScan);
+    RUN_TEST(test_SoftwareTimer_Group_LazyRebaseAcrossWrap);
+    RUN_TEST(test_SoftwareTimer_Manager_PeriodicCatchUpSkipsMissedPeriods);
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+    RUN_TEST(test_SoftwareTimer_Concurrent_ArmCancelAndRearm);
+    RUN_TEST(test_SoftwareTimer_Concurrent_RequestBeingWrittenIsRetried);
+    #if defined(__unix__) || defined(__APPLE__)
+    RUN_TEST(test_SoftwareTimer_Concurrent_ArmFromManyThreads);
+    RUN_TEST(test_SoftwareTimer_Concurrent_CancelSync);
+    RUN_TEST(test_SoftwareTimer_Concurrent_CancelSyncWakesSleepingThread);
+    #endif
+#endif
+#if defined(SOFTWARETIMER_CRITICAL) && (defined(__unix__) || defined(__APPLE__)) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_ATOMICS__)
+    RUN_TEST(test_SoftwareTimer_Manager_ArmAndStopFromManyThreads);
+#endif
+    RUN_TEST(test_SoftwareTimer_Pll_LocksToDriftingReference);
+    RUN_TEST(test_SoftwareTimer_Manager_SoftEntriesAlignToGrid);
+    RUN_TEST(test_SoftwareTimer_Cyclic_FrameTableAndOverrun);
+    RUN_TEST(test_SoftwareTimer_Broadcast_FansOutFromOneEntry);
+#ifdef SOFTWARETIMER_FREERTOS
+    RUN_TEST(test_SoftwareTimer_FreeRtos_TickHookIdleAndTaskLoop);
+#endif
+#if defined(SOFTWARETIMER_IOURING) && defined(__linux__)
+    RUN_TEST(test_SoftwareTimer_Uring_TimeoutLifecycle);
+    RUN_TEST(test_SoftwareTimer_Uring_FallsBackToTimerfd);
+#endif
 
     return UNITY_END();
 }